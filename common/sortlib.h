@@ -0,0 +1,623 @@
+﻿#pragma once
+// 头文件式排序库，exp1与exp4共用。
+// 所有算法都作用于随机访问迭代器区间[first, last)，比较的是投影proj(元素)得到的关键字：
+// comp(proj(a), proj(b))为true表示a应排在b之前。默认投影为元素本身、比较器为std::less<>（升序）。
+// sort/stableSort在编译期选择算法：关键字为算术类型且比较器为std::less/std::greater时用基数排序，
+// 否则分别用内省式快速排序/自底向上归并排序；不超过INSERTION_SORT_THRESHOLD个元素时直接插入排序。
+// 只用到C++14，编译期选择用标签分派实现
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sortlib {
+
+// 默认投影：原样返回元素
+struct Identity {
+    template <typename T>
+    T&& operator()(T&& x) const { return std::forward<T>(x); }
+};
+
+const std::ptrdiff_t INSERTION_SORT_THRESHOLD = 32;  // 不超过此长度时sort/stableSort直接插入排序
+const std::ptrdiff_t PARALLEL_SORT_CUTOFF = 1 << 14; // 短于此长度的段不再拆分给新线程
+
+namespace detail {
+
+// 把投影并入比较器，得到直接比较两个元素的比较器
+template <typename Compare, typename Proj>
+struct ProjectedLess {
+    Compare comp;
+    Proj proj;
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const { return comp(proj(a), proj(b)); }
+};
+
+template <typename Compare, typename Proj>
+ProjectedLess<Compare, Proj> projected(Compare comp, Proj proj) {
+    return ProjectedLess<Compare, Proj>{ comp, proj };
+}
+
+template <typename It>
+using ValueOf = typename std::iterator_traits<It>::value_type;
+
+// 投影后关键字的类型
+template <typename It, typename Proj>
+using KeyOf = typename std::decay<decltype(std::declval<Proj&>()(*std::declval<It>()))>::type;
+
+// 对[first, last)做插入排序（稳定）
+template <typename It, typename Less>
+void insertionSort(It first, It last, Less less) {
+    if (last - first < 2) return;
+    for (It i = first + 1; i != last; ++i) {
+        if (!less(*i, *(i - 1))) continue;
+        ValueOf<It> key = std::move(*i);
+        It j = i;
+        do {
+            *j = std::move(*(j - 1));
+            --j;
+        } while (j != first && less(key, *(j - 1)));
+        *j = std::move(key);
+    }
+}
+
+// 把src中相邻的有序段[left, mid)与[mid, right)稳定地合并到dst的同一位置（相等时前段优先），
+// 两段已整体有序时直接搬运
+template <typename Src, typename Dst, typename Less>
+void mergeRuns(Src src, Dst dst, std::ptrdiff_t left, std::ptrdiff_t mid, std::ptrdiff_t right, Less less) {
+    if (mid >= right || !less(src[mid], src[mid - 1])) {
+        std::move(src + left, src + right, dst + left);
+        return;
+    }
+    std::ptrdiff_t i = left, j = mid, k = left;
+    while (i < mid && j < right) {
+        if (less(src[j], src[i])) dst[k++] = std::move(src[j++]);
+        else dst[k++] = std::move(src[i++]);
+    }
+    while (i < mid) dst[k++] = std::move(src[i++]);
+    while (j < right) dst[k++] = std::move(src[j++]);
+}
+
+// 按bounds给出的段边界（首项0、末项n）逐轮两两归并相邻段，在区间与缓冲区之间来回搬运，
+// 结果总是回到区间中
+template <typename It, typename Less>
+void mergeAllRuns(It first, std::ptrdiff_t n, std::vector<std::ptrdiff_t>& bounds, Less less) {
+    if (bounds.size() <= 2) return;
+    std::vector<ValueOf<It>> buffer(n);
+    bool inBuffer = false;
+    while (bounds.size() > 2) {
+        size_t w = 0;
+        for (size_t k = 0; k + 1 < bounds.size(); k += 2) {
+            std::ptrdiff_t left = bounds[k], mid = bounds[k + 1];
+            std::ptrdiff_t right = k + 2 < bounds.size() ? bounds[k + 2] : mid;
+            if (inBuffer) detail::mergeRuns(buffer.begin(), first, left, mid, right, less);
+            else detail::mergeRuns(first, buffer.begin(), left, mid, right, less);
+            bounds[w++] = left;
+        }
+        bounds[w++] = n;
+        bounds.resize(w);
+        inBuffer = !inBuffer;
+    }
+    if (inBuffer) std::move(buffer.begin(), buffer.end(), first);
+}
+
+// 把a、b、c三处排好，中位数落在b处
+template <typename It, typename Less>
+void sort3(It a, It b, It c, Less less) {
+    if (less(*b, *a)) std::iter_swap(a, b);
+    if (less(*c, *b)) std::iter_swap(b, c);
+    if (less(*b, *a)) std::iter_swap(a, b);
+}
+
+// 内省式快速排序主循环：长区间九数取中、较短区间三数取中选基准；三路分区（基准留在lo处不动，
+// 分完再换入相等段）；划分极不均衡时打乱两侧若干元素，超过深度上限改用堆排序；
+// 只递归较短的一侧，栈深度为O(log n)
+template <typename It, typename Less>
+void quickSortLoop(It lo, It hi, int depthLimit, Less less) {
+    const std::ptrdiff_t CUTOFF = 24;
+    while (hi - lo > CUTOFF) {
+        std::ptrdiff_t n = hi - lo;
+        if (depthLimit-- == 0) {
+            std::make_heap(lo, hi, less);
+            std::sort_heap(lo, hi, less);
+            return;
+        }
+
+        It mid = lo + n / 2;
+        if (n > 128) {
+            std::ptrdiff_t step = n / 8;
+            detail::sort3(lo, lo + step, lo + 2 * step, less);
+            detail::sort3(mid - step, mid, mid + step, less);
+            detail::sort3(hi - 1 - 2 * step, hi - 1 - step, hi - 1, less);
+            detail::sort3(lo + step, mid, hi - 1 - step, less);
+        }
+        else {
+            detail::sort3(lo, mid, hi - 1, less);
+        }
+        std::iter_swap(lo, mid);
+
+        // [lo+1, lt)小于基准，[lt, i)等于基准，(gt, hi)大于基准
+        It lt = lo + 1, i = lo + 1, gt = hi - 1;
+        while (i <= gt) {
+            if (less(*i, *lo)) std::iter_swap(lt++, i++);
+            else if (less(*lo, *i)) std::iter_swap(i, gt--);
+            else ++i;
+        }
+        std::iter_swap(lo, --lt);
+        std::ptrdiff_t leftSize = lt - lo, rightSize = hi - (gt + 1);
+
+        if (std::min(leftSize, rightSize) < n / 8) {
+            if (leftSize >= CUTOFF) {
+                std::iter_swap(lo, lo + leftSize / 4);
+                std::iter_swap(lt - 1, lt - leftSize / 4);
+            }
+            if (rightSize >= CUTOFF) {
+                std::iter_swap(gt + 1, gt + 1 + rightSize / 4);
+                std::iter_swap(hi - 1, hi - rightSize / 4);
+            }
+        }
+
+        if (leftSize < rightSize) {
+            detail::quickSortLoop(lo, lt, depthLimit, less);
+            lo = gt + 1;
+        }
+        else {
+            detail::quickSortLoop(gt + 1, hi, depthLimit, less);
+            hi = lt;
+        }
+    }
+    detail::insertionSort(lo, hi, less);
+}
+
+// ---------- 基数排序的关键字编码 ----------
+template <size_t N> struct UIntOf;
+template <> struct UIntOf<1> { typedef uint8_t type; };
+template <> struct UIntOf<2> { typedef uint16_t type; };
+template <> struct UIntOf<4> { typedef uint32_t type; };
+template <> struct UIntOf<8> { typedef uint64_t type; };
+
+// 把算术类型的关键字编码为无符号整数，编码的大小顺序与关键字的升序一致
+template <typename Key, bool IsFloat = std::is_floating_point<Key>::value>
+struct RadixCodec {
+    typedef typename UIntOf<sizeof(Key)>::type Bits;
+    static Bits encode(Key key) {
+        Bits u = (Bits)key;
+        if (std::is_signed<Key>::value) u ^= (Bits)((Bits)1 << (8 * sizeof(Bits) - 1));  // 有符号整数翻转符号位
+        return u;
+    }
+};
+
+// IEEE-754浮点数：正数翻转符号位，负数整体取反。
+// -0.0与+0.0比较相等，先统一成+0.0，否则-0.0会排在+0.0前面而不再稳定
+template <typename Key>
+struct RadixCodec<Key, true> {
+    typedef typename UIntOf<sizeof(Key)>::type Bits;
+    static Bits encode(Key key) {
+        if (key == 0) key = 0;
+        Bits u;
+        std::memcpy(&u, &key, sizeof(u));
+        const Bits sign = (Bits)((Bits)1 << (8 * sizeof(Bits) - 1));
+        return (u & sign) ? (Bits)~u : (Bits)(u | sign);
+    }
+};
+
+// 比较器对应的基数排序方向：1升序，-1降序，0不能用基数排序
+template <typename Compare, typename Key> struct RadixDirection : std::integral_constant<int, 0> {};
+template <typename Key> struct RadixDirection<std::less<>, Key> : std::integral_constant<int, 1> {};
+template <typename Key> struct RadixDirection<std::less<Key>, Key> : std::integral_constant<int, 1> {};
+template <typename Key> struct RadixDirection<std::greater<>, Key> : std::integral_constant<int, -1> {};
+template <typename Key> struct RadixDirection<std::greater<Key>, Key> : std::integral_constant<int, -1> {};
+
+// 能否用基数排序：关键字为不超过8字节的算术类型，且比较器为std::less/std::greater
+template <typename Compare, typename Key>
+struct UseRadix : std::integral_constant<bool,
+    std::is_arithmetic<Key>::value && sizeof(Key) <= 8 &&
+    !std::is_same<Key, long double>::value && RadixDirection<Compare, Key>::value != 0> {};
+
+// 按order重排[first, first+n)：第k个位置放原来的第order[k]个元素
+template <typename It>
+void applyOrder(It first, const std::vector<int>& order) {
+    std::vector<ValueOf<It>> sorted;
+    sorted.reserve(order.size());
+    for (int k : order) sorted.push_back(std::move(first[k]));
+    std::move(sorted.begin(), sorted.end(), first);
+}
+
+// 在多个线程上运行work(t, lo, hi)，[lo, hi)为第t段
+template <typename Work>
+void runChunks(int numThreads, std::ptrdiff_t n, Work work) {
+    std::ptrdiff_t chunk = (n + numThreads - 1) / numThreads;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < numThreads; ++t) {
+        std::ptrdiff_t lo = std::min(n, t * chunk), hi = std::min(n, lo + chunk);
+        workers.emplace_back(work, t, lo, hi);
+    }
+    for (auto& w : workers) w.join();
+}
+
+inline int defaultThreads(int numThreads) {
+    return numThreads > 0 ? numThreads : (int)std::max(1u, std::thread::hardware_concurrency());
+}
+
+// 线程数对应的二分深度：depth层二分最多产生2^depth个并发任务
+inline int parallelDepth(int numThreads) {
+    int depth = 0;
+    while ((1 << depth) < numThreads) depth++;
+    return depth;
+}
+
+// 并行归并：把有序段[a1, a2)与[b1, b2)稳定地合并到out（相等时a段优先）。
+// 取较长段的中点x，在另一段中二分出x的位置，两侧分别归并，左侧交给新线程
+template <typename In, typename Out, typename Less>
+void parallelMerge(In a1, In a2, In b1, In b2, Out out, Less less, int depth) {
+    std::ptrdiff_t na = a2 - a1, nb = b2 - b1;
+    if (depth <= 0 || na + nb < PARALLEL_SORT_CUTOFF) {
+        std::merge(std::make_move_iterator(a1), std::make_move_iterator(a2),
+            std::make_move_iterator(b1), std::make_move_iterator(b2), out, less);
+        return;
+    }
+    In aMid, bMid;
+    if (na >= nb) {
+        aMid = a1 + na / 2;
+        bMid = std::lower_bound(b1, b2, *aMid, less);  // b段中严格小于x的排在x之前
+    }
+    else {
+        bMid = b1 + nb / 2;
+        aMid = std::upper_bound(a1, a2, *bMid, less);  // a段中等于x的也排在x之前
+    }
+    Out outMid = out + (aMid - a1) + (bMid - b1);
+    std::thread left([=]() { detail::parallelMerge(a1, aMid, b1, bMid, out, less, depth - 1); });
+    detail::parallelMerge(aMid, a2, bMid, b2, outMid, less, depth - 1);
+    left.join();
+}
+
+// 对src中的n个元素排序，toDst为true时结果放在dst，否则留在src。
+// 两半的结果放在另一组存储中，再并行归并到目标处，每层只搬运一次
+template <typename It, typename Buf, typename Less>
+void parallelMergeSortRec(It src, Buf dst, std::ptrdiff_t n, bool toDst, Less less, int depth) {
+    if (depth <= 0 || n < PARALLEL_SORT_CUTOFF) {
+        std::stable_sort(src, src + n, less);
+        if (toDst) std::move(src, src + n, dst);
+        return;
+    }
+    std::ptrdiff_t mid = n / 2;
+    std::thread left([=]() { detail::parallelMergeSortRec(src, dst, mid, !toDst, less, depth - 1); });
+    detail::parallelMergeSortRec(src + mid, dst + mid, n - mid, !toDst, less, depth - 1);
+    left.join();
+    if (toDst) detail::parallelMerge(src, src + mid, src + mid, src + n, dst, less, depth);
+    else detail::parallelMerge(dst, dst + mid, dst + mid, dst + n, src, less, depth);
+}
+
+} // namespace detail
+
+// ====================== 基础排序算法 ======================
+// 插入排序（稳定）
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void insertionSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    detail::insertionSort(first, last, detail::projected(comp, proj));
+}
+
+// 冒泡排序（稳定），某一趟没有交换时提前结束
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void bubbleSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    auto less = detail::projected(comp, proj);
+    for (It end = last; end - first > 1; --end) {
+        bool swapped = false;
+        for (It j = first; j + 1 != end; ++j) {
+            if (less(*(j + 1), *j)) {
+                std::iter_swap(j, j + 1);
+                swapped = true;
+            }
+        }
+        if (!swapped) break;
+    }
+}
+
+// 自底向上归并排序（稳定）：先对每32个元素插入排序，再按段长逐轮归并；
+// 整个排序只分配一次辅助缓冲区，每轮在区间与缓冲区之间来回归并，已有序的相邻段只搬运不比较
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void mergeSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    const std::ptrdiff_t BLOCK = 32;
+    auto less = detail::projected(comp, proj);
+    std::ptrdiff_t n = last - first;
+    std::vector<std::ptrdiff_t> bounds;
+    for (std::ptrdiff_t lo = 0; lo < n; lo += BLOCK) {
+        detail::insertionSort(first + lo, first + std::min(n, lo + BLOCK), less);
+        bounds.push_back(lo);
+    }
+    bounds.push_back(n);
+    detail::mergeAllRuns(first, n, bounds, less);
+}
+
+// 自然归并排序（稳定）：先扫描出天然有序段（严格逆序段原地翻转，不足32个的段用插入排序补足），
+// 再逐轮两两归并相邻段；已有序或接近有序的输入只需O(n)
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void naturalMergeSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    const std::ptrdiff_t MIN_RUN = 32;
+    auto less = detail::projected(comp, proj);
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+
+    std::vector<std::ptrdiff_t> bounds(1, 0);
+    for (std::ptrdiff_t i = 0; i < n;) {
+        std::ptrdiff_t j = i + 1;
+        if (j < n && less(first[j], first[j - 1])) {
+            while (j < n && less(first[j], first[j - 1])) j++;
+            std::reverse(first + i, first + j);
+        }
+        else {
+            while (j < n && !less(first[j], first[j - 1])) j++;
+        }
+        if (j - i < MIN_RUN) {
+            j = std::min(n, i + MIN_RUN);
+            detail::insertionSort(first + i, first + j, less);
+        }
+        bounds.push_back(j);
+        i = j;
+    }
+    detail::mergeAllRuns(first, n, bounds, less);
+}
+
+// 内省式快速排序（不稳定）：有序、逆序或大量相等关键字的输入都不会退化，最坏O(n log n)
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void quickSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    int depthLimit = 0;
+    for (std::ptrdiff_t n = last - first; n > 1; n >>= 1) depthLimit += 2;  // 约2*log2(n)
+    detail::quickSortLoop(first, last, depthLimit, detail::projected(comp, proj));
+}
+
+// ====================== 基数排序 ======================
+// 算出稳定排序后的原下标序列order，不移动元素。关键字编码为无符号整数（降序时再取反），
+// 与下标一起按字节做LSD分配，各字节的计数在一次扫描中统计完，某字节全部相同的一趟直接跳过
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void radixSortOrder(It first, It last, std::vector<int>& order, Compare = Compare(), Proj proj = Proj()) {
+    typedef detail::KeyOf<It, Proj> Key;
+    static_assert(detail::UseRadix<Compare, Key>::value,
+        "radixSort requires an arithmetic key and std::less/std::greater");
+    typedef typename detail::RadixCodec<Key>::Bits Bits;
+    const bool descending = detail::RadixDirection<Compare, Key>::value < 0;
+    const int BYTES = sizeof(Bits);
+
+    int n = last - first;
+    std::vector<Bits> keys(n), keysTmp(n);
+    std::vector<int> orderTmp(n);
+    order.resize(n);
+    std::vector<int> count(BYTES * 256, 0);
+    for (int i = 0; i < n; ++i) {
+        Bits k = detail::RadixCodec<Key>::encode(proj(first[i]));
+        if (descending) k = ~k;
+        keys[i] = k;
+        order[i] = i;
+        for (int b = 0; b < BYTES; ++b) count[b * 256 + ((k >> (8 * b)) & 255)]++;
+    }
+
+    for (int b = 0; b < BYTES; ++b) {
+        int shift = 8 * b;
+        int* c = &count[b * 256];
+        if (n == 0 || c[(keys[0] >> shift) & 255] == n) continue;
+        int sum = 0;
+        for (int d = 0; d < 256; ++d) {
+            int t = c[d];
+            c[d] = sum;
+            sum += t;
+        }
+        for (int i = 0; i < n; ++i) {
+            int pos = c[(keys[i] >> shift) & 255]++;
+            keysTmp[pos] = keys[i];
+            orderTmp[pos] = order[i];
+        }
+        keys.swap(keysTmp);
+        order.swap(orderTmp);
+    }
+}
+
+// 基数排序（稳定）：先算出下标序列，再整体重排一次
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void radixSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    std::vector<int> order;
+    sortlib::radixSortOrder(first, last, order, comp, proj);
+    detail::applyOrder(first, order);
+}
+
+// 多线程基数排序（结果与radixSort相同）：区间按线程数均分成段，每趟各线程统计本段的字节计数，
+// 按"字节值优先、段号其次"求前缀和得到各段的写入起点，再各自分配到目标位置，保持稳定
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void parallelRadixSortOrder(It first, It last, std::vector<int>& order,
+    Compare comp = Compare(), Proj proj = Proj(), int numThreads = 0) {
+    typedef detail::KeyOf<It, Proj> Key;
+    static_assert(detail::UseRadix<Compare, Key>::value,
+        "radixSort requires an arithmetic key and std::less/std::greater");
+    typedef typename detail::RadixCodec<Key>::Bits Bits;
+    const bool descending = detail::RadixDirection<Compare, Key>::value < 0;
+    const int BYTES = sizeof(Bits);
+
+    int n = last - first;
+    numThreads = std::min(detail::defaultThreads(numThreads), std::max(1, n / 4096));  // 每段太短时线程开销得不偿失
+    if (numThreads == 1) {
+        sortlib::radixSortOrder(first, last, order, comp, proj);
+        return;
+    }
+
+    std::vector<Bits> keys(n), keysTmp(n);
+    std::vector<int> orderTmp(n);
+    order.resize(n);
+    std::vector<int> count((size_t)numThreads * 256);
+
+    detail::runChunks(numThreads, n, [&](int, std::ptrdiff_t lo, std::ptrdiff_t hi) {
+        for (std::ptrdiff_t i = lo; i < hi; ++i) {
+            Bits k = detail::RadixCodec<Key>::encode(proj(first[i]));
+            keys[i] = descending ? (Bits)~k : k;
+            order[i] = (int)i;
+        }
+    });
+
+    for (int b = 0; b < BYTES; ++b) {
+        int shift = 8 * b;
+        detail::runChunks(numThreads, n, [&](int t, std::ptrdiff_t lo, std::ptrdiff_t hi) {
+            int* c = &count[(size_t)t * 256];
+            std::fill(c, c + 256, 0);
+            for (std::ptrdiff_t i = lo; i < hi; ++i) c[(keys[i] >> shift) & 255]++;
+        });
+
+        // 所有元素该字节相同（各段计数之和为n）时本趟不改变次序
+        bool skip = false;
+        for (int d = 0; d < 256 && !skip; ++d) {
+            int total = 0;
+            for (int t = 0; t < numThreads; ++t) total += count[(size_t)t * 256 + d];
+            if (total == n) skip = true;
+        }
+        if (skip) continue;
+
+        int sum = 0;
+        for (int d = 0; d < 256; ++d) {
+            for (int t = 0; t < numThreads; ++t) {
+                int c = count[(size_t)t * 256 + d];
+                count[(size_t)t * 256 + d] = sum;
+                sum += c;
+            }
+        }
+
+        detail::runChunks(numThreads, n, [&](int t, std::ptrdiff_t lo, std::ptrdiff_t hi) {
+            int* offset = &count[(size_t)t * 256];
+            for (std::ptrdiff_t i = lo; i < hi; ++i) {
+                int pos = offset[(keys[i] >> shift) & 255]++;
+                keysTmp[pos] = keys[i];
+                orderTmp[pos] = order[i];
+            }
+        });
+        keys.swap(keysTmp);
+        order.swap(orderTmp);
+    }
+}
+
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void parallelRadixSort(It first, It last, Compare comp = Compare(), Proj proj = Proj(), int numThreads = 0) {
+    std::vector<int> order;
+    sortlib::parallelRadixSortOrder(first, last, order, comp, proj, numThreads);
+    detail::applyOrder(first, order);
+}
+
+// ====================== 并行排序 ======================
+// 并行归并排序（稳定，结果与std::stable_sort相同）：分治排序与归并都按二分深度派生线程
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void parallelMergeSort(It first, It last, Compare comp = Compare(), Proj proj = Proj(), int numThreads = 0) {
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    std::vector<detail::ValueOf<It>> buffer(n);
+    detail::parallelMergeSortRec(first, buffer.begin(), n, false, detail::projected(comp, proj),
+        detail::parallelDepth(detail::defaultThreads(numThreads)));
+}
+
+// 样本排序（稳定，结果与std::stable_sort相同）：
+// 等距抽取numThreads*32个样本排序后选出numThreads-1个分隔元素，把数据分成numThreads个桶；
+// 各线程统计本段落入各桶的个数，按"桶号优先、段号其次"求前缀和后并行分配到缓冲区，
+// 相等元素总落在同一个桶且保持原有先后，最后各桶由空闲线程认领并各自stable_sort。
+// 大量相等元素集中在一个桶时退化为单线程排序该桶
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void sampleSort(It first, It last, Compare comp = Compare(), Proj proj = Proj(), int numThreads = 0) {
+    typedef detail::ValueOf<It> T;
+    auto less = detail::projected(comp, proj);
+    numThreads = detail::defaultThreads(numThreads);
+    std::ptrdiff_t n = last - first;
+    int buckets = numThreads;
+    if (buckets == 1 || n < PARALLEL_SORT_CUTOFF) {
+        std::stable_sort(first, last, less);
+        return;
+    }
+
+    std::ptrdiff_t sampleCount = (std::ptrdiff_t)buckets * 32;
+    std::vector<T> samples;
+    samples.reserve(sampleCount);
+    for (std::ptrdiff_t k = 0; k < sampleCount; ++k) samples.push_back(first[k * n / sampleCount]);
+    std::sort(samples.begin(), samples.end(), less);
+    std::vector<T> splitters;
+    for (int b = 1; b < buckets; ++b) splitters.push_back(samples[b * 32]);
+    auto bucketOf = [&](const T& x) {
+        return (int)(std::upper_bound(splitters.begin(), splitters.end(), x, less) - splitters.begin());
+    };
+
+    std::vector<size_t> offset((size_t)numThreads * buckets, 0);
+    detail::runChunks(numThreads, n, [&](int t, std::ptrdiff_t lo, std::ptrdiff_t hi) {
+        size_t* count = &offset[(size_t)t * buckets];
+        for (std::ptrdiff_t i = lo; i < hi; ++i) count[bucketOf(first[i])]++;
+    });
+    std::vector<size_t> bucketStart(buckets + 1);
+    size_t sum = 0;
+    for (int b = 0; b < buckets; ++b) {
+        bucketStart[b] = sum;
+        for (int t = 0; t < numThreads; ++t) {
+            size_t c = offset[(size_t)t * buckets + b];
+            offset[(size_t)t * buckets + b] = sum;
+            sum += c;
+        }
+    }
+    bucketStart[buckets] = n;
+
+    std::vector<T> buffer(n);
+    detail::runChunks(numThreads, n, [&](int t, std::ptrdiff_t lo, std::ptrdiff_t hi) {
+        size_t* pos = &offset[(size_t)t * buckets];
+        for (std::ptrdiff_t i = lo; i < hi; ++i) buffer[pos[bucketOf(first[i])]++] = std::move(first[i]);
+    });
+
+    std::atomic<int> nextBucket(0);
+    detail::runChunks(numThreads, numThreads, [&](int, std::ptrdiff_t, std::ptrdiff_t) {
+        for (int b = nextBucket++; b < buckets; b = nextBucket++) {
+            std::stable_sort(buffer.begin() + bucketStart[b], buffer.begin() + bucketStart[b + 1], less);
+        }
+    });
+    std::move(buffer.begin(), buffer.end(), first);
+}
+
+// ====================== 自动选择算法 ======================
+namespace detail {
+
+template <typename It, typename Compare, typename Proj>
+void sortDispatch(It first, It last, Compare comp, Proj proj, std::true_type) {
+    sortlib::radixSort(first, last, comp, proj);
+}
+
+template <typename It, typename Compare, typename Proj>
+void sortDispatch(It first, It last, Compare comp, Proj proj, std::false_type) {
+    sortlib::quickSort(first, last, comp, proj);
+}
+
+template <typename It, typename Compare, typename Proj>
+void stableSortDispatch(It first, It last, Compare comp, Proj proj, std::true_type) {
+    sortlib::radixSort(first, last, comp, proj);
+}
+
+template <typename It, typename Compare, typename Proj>
+void stableSortDispatch(It first, It last, Compare comp, Proj proj, std::false_type) {
+    sortlib::mergeSort(first, last, comp, proj);
+}
+
+} // namespace detail
+
+// 排序（不保证稳定）：短区间插入排序，算术关键字基数排序，其余内省式快速排序
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void sort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    if (last - first <= INSERTION_SORT_THRESHOLD) {
+        sortlib::insertionSort(first, last, comp, proj);
+        return;
+    }
+    detail::sortDispatch(first, last, comp, proj,
+        typename detail::UseRadix<Compare, detail::KeyOf<It, Proj>>::type());
+}
+
+// 稳定排序：短区间插入排序，算术关键字基数排序，其余自底向上归并排序
+template <typename It, typename Compare = std::less<>, typename Proj = Identity>
+void stableSort(It first, It last, Compare comp = Compare(), Proj proj = Proj()) {
+    if (last - first <= INSERTION_SORT_THRESHOLD) {
+        sortlib::insertionSort(first, last, comp, proj);
+        return;
+    }
+    detail::stableSortDispatch(first, last, comp, proj,
+        typename detail::UseRadix<Compare, detail::KeyOf<It, Proj>>::type());
+}
+
+} // namespace sortlib
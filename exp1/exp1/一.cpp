@@ -6,6 +6,12 @@
 #include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <chrono>
+#include <thread>
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include "sortlib.h"
 
 using namespace std;
 
@@ -75,20 +81,9 @@ int findComplex(const vector<Complex>& vec, const Complex& target) {
     return -1;  // δҵ
 }
 
-// ʵ
+// ʵ֣㷨ͳһcommon/sortlib.hṩ
 void bubbleSort(vector<Complex>& vec) {
-    int n = vec.size();
-    bool swapped;
-    for (int i = 0; i < n - 1; ++i) {
-        swapped = false;
-        for (int j = 0; j < n - i - 1; ++j) {
-            if (!compareComplex(vec[j], vec[j + 1])) {
-                swap(vec[j], vec[j + 1]);
-                swapped = true;
-            }
-        }
-        if (!swapped) break;  // ǰ˳
-    }
+    sortlib::bubbleSort(vec.begin(), vec.end(), compareComplex);
 }
 
 // 鲢ϲ
@@ -124,12 +119,22 @@ void mergeSortHelper(vector<Complex>& vec, int left, int right) {
     }
 }
 
-// 鲢
+// 鲢ڣݹ棬Աȣ
 void mergeSort(vector<Complex>& vec) {
     if (vec.empty()) return;
     mergeSortHelper(vec, 0, vec.size() - 1);
 }
 
+// ԵϹ鲢ֻһλȶ
+void bottomUpMergeSort(vector<Complex>& vec) {
+    sortlib::mergeSort(vec.begin(), vec.end(), compareComplex);
+}
+
+// Ȼ鲢ȻΣӽʱΪO(n)
+void naturalMergeSort(vector<Complex>& vec) {
+    sortlib::naturalMergeSort(vec.begin(), vec.end(), compareComplex);
+}
+
 // 㷨ʱ䣨غ룩
 double testSortTime(void (*sortFunc)(vector<Complex>&), vector<Complex> vec) {
     clock_t start = clock();
@@ -138,6 +143,21 @@ double testSortTime(void (*sortFunc)(vector<Complex>&), vector<Complex> vec) {
     return (double)(end - start) / CLOCKS_PER_SEC * 1000;
 }
 
+// work()ǽӺʱغ룩clock()ڲƽ̨ۼƵ̵߳CPUʱ䣬ʺ϶̴߳
+template <typename Work>
+double wallTime(Work work) {
+    auto start = chrono::high_resolution_clock::now();
+    work();
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+}
+
+// ǽӺʱغ룩
+template <typename SortFunc>
+double testWallTime(SortFunc sortFunc, vector<Complex>& vec) {
+    return wallTime([&]() { sortFunc(vec); });
+}
+
 // 
 vector<Complex> generateOrderedVector(int size, int range) {
     vector<Complex> vec = generateRandomVector(size, range);
@@ -167,17 +187,831 @@ int lowerBound(const vector<Complex>& vec, double m) {
     return left;
 }
 
-// ңģ[m1, m2)Ԫ
+// һθֻͼֻ¼βָ룬Ԫأ൱C++20span<const Complex>
+// ͼָԭڴ棬ԭݻٺͼʧЧ
+class ComplexSpan {
+public:
+    ComplexSpan() : first(nullptr), last(nullptr) {}
+    ComplexSpan(const Complex* first, const Complex* last) : first(first), last(last) {}
+
+    const Complex* begin() const { return first; }
+    const Complex* end() const { return last; }
+    int size() const { return last - first; }
+    bool empty() const { return first == last; }
+    const Complex& operator[](int i) const { return first[i]; }
+
+private:
+    const Complex* first;
+    const Complex* last;
+};
+
+// ңģ[m1, m2)Ԫأͼ
+ComplexSpan rangeView(const vector<Complex>& orderedVec, double m1, double m2) {
+    int start = lowerBound(orderedVec, m1);
+    int end = max(start, lowerBound(orderedVec, m2));
+    return ComplexSpan(orderedVec.data() + start, orderedVec.data() + end);
+}
+
+// ңģ[m1, m2)ԪأƵ
 vector<Complex> rangeSearch(const vector<Complex>& orderedVec, double m1, double m2) {
+    ComplexSpan view = rangeView(orderedVec, m1, m2);
+    return vector<Complex>(view.begin(), view.end());
+}
+
+// ģƽ norm[i] = re[i]^2 + im[i]^2Complex::mod()ڵıʽͬȳ˺ӣFMAλһ
+void computeNorms(const double* re, const double* im, double* norm, int n) {
+    int i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= n; i += 4) {
+        __m256d r = _mm256_loadu_pd(re + i);
+        __m256d m = _mm256_loadu_pd(im + i);
+        _mm256_storeu_pd(norm + i, _mm256_add_pd(_mm256_mul_pd(r, r), _mm256_mul_pd(m, m)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 2 <= n; i += 2) {
+        __m128d r = _mm_loadu_pd(re + i);
+        __m128d m = _mm_loadu_pd(im + i);
+        _mm_storeu_pd(norm + i, _mm_add_pd(_mm_mul_pd(r, r), _mm_mul_pd(m, m)));
+    }
+#endif
+    for (; i < n; ++i) norm[i] = re[i] * re[i] + im[i] * im[i];
+}
+
+// ģƽʵcompareComplex|ģA - ģB| = |normA - normB| / (ģA + ģB)
+//  normA + normB <= (ģA +ģB)^2 <= 2(normA + normB)Զֻģƽ֮ж
+// "ģ֮Ƿeps"ֻ֮ʱſԭʽȽ
+inline bool lessByNorm(double normA, double realA, double normB, double realB) {
+    const double eps = 1e-6;
+    double d = normA - normB, s = normA + normB;
+    if (d * d > 2.5 * eps * eps * s) return d < 0;          // ģ֮һeps
+    if (d * d < 0.5 * eps * eps * s) return realA < realB;  // ģ֮һeps
+    double modA = sqrt(normA), modB = sqrt(normB);
+    if (fabs(modA - modB) > eps) {
+        return modA < modB;
+    }
+    return realA < realB;
+}
+
+// ģ < m ȼ ģƽ < ttsqrt(t) >= mСdoublesqrtÿβֻһ
+double normThreshold(double m) {
+    if (!(m > 0)) return 0;
+    double t = m * m;
+    while (t > 0 && sqrt(nextafter(t, 0.0)) >= m) t = nextafter(t, 0.0);
+    while (sqrt(t) < m) t = nextafter(t, HUGE_VAL);
+    return t;
+}
+
+// дŵĸ飨SoAʵ鲿뻺ģƽռһ顣
+// ֻȽģƽÿο밴compareComplex򡢰mod()ȫͬ
+class ComplexArray {
+public:
+    vector<double> re;    // ʵ
+    vector<double> im;    // 鲿
+    vector<double> norm;  // ģƽ
+
+    ComplexArray() {}
+    explicit ComplexArray(const vector<Complex>& vec) { assign(vec); }
+
+    void assign(const vector<Complex>& vec) {
+        int n = vec.size();
+        re.resize(n);
+        im.resize(n);
+        norm.resize(n);
+        for (int i = 0; i < n; ++i) {
+            re[i] = vec[i].getReal();
+            im[i] = vec[i].getImag();
+        }
+        computeNorms(re.data(), im.data(), norm.data(), n);
+    }
+
+    int size() const { return re.size(); }
+    Complex operator[](int i) const { return Complex(re[i], im[i]); }
+    double mod(int i) const { return sqrt(norm[i]); }
+
+    vector<Complex> toVector() const {
+        vector<Complex> vec;
+        vec.reserve(size());
+        for (int i = 0; i < size(); ++i) vec.emplace_back(re[i], im[i]);
+        return vec;
+    }
+
+    // ԪiǷԪj֮ǰcompareComplex((*this)[i], (*this)[j])ͬ
+    bool less(int i, int j) const { return lessByNorm(norm[i], re[i], norm[j], re[j]); }
+
+    // ȶȰģƽ򣬲καȽϣҳģ֮ܲepsĶ
+    // ʱģȵĶΣڰcompareComplexĹʱԭ±š
+    // compareComplexϸʱ꣩stable_sort(vec, compareComplex)ͬ
+    void sort() {
+        const double eps = 1e-6;
+        int n = size();
+        vector<int> order;
+        sortlib::radixSortOrder(norm.begin(), norm.end(), order);
+        for (int i = 0; i < n;) {
+            int j = i + 1;
+            while (j < n) {
+                double d = norm[order[j]] - norm[order[j - 1]], s = norm[order[j]] + norm[order[j - 1]];
+                if (d * d > 2.5 * eps * eps * s) break;  // lessByNormĵһͬģ֮һeps
+                ++j;
+            }
+            if (j - i > 1) {
+                sortlib::sort(order.begin() + i, order.begin() + j, [this](int a, int b) {
+                    if (less(a, b)) return true;
+                    if (less(b, a)) return false;
+                    return a < b;
+                });
+            }
+            i = j;
+        }
+        vector<double> newRe(n), newIm(n), newNorm(n);
+        for (int i = 0; i < n; ++i) {
+            newRe[i] = re[order[i]];
+            newIm[i] = im[order[i]];
+            newNorm[i] = norm[order[i]];
+        }
+        re.swap(newRe);
+        im.swap(newIm);
+        norm.swap(newNorm);
+    }
+
+    // ֲ½磨һģ >= mԪأlowerBound(vector<Complex>, m)̽ͬλ
+    int lowerBound(double m) const {
+        double t = normThreshold(m);
+        int left = 0, right = size();
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+            if (norm[mid] < t) {
+                left = mid + 1;
+            }
+            else {
+                right = mid;
+            }
+        }
+        return left;
+    }
+
+    // ңģ[m1, m2)Ԫ
+    ComplexArray rangeSearch(double m1, double m2) const {
+        ComplexArray result;
+        int start = lowerBound(m1);
+        int end = max(start, lowerBound(m2));
+        result.re.assign(re.begin() + start, re.begin() + end);
+        result.im.assign(im.begin() + start, im.begin() + end);
+        result.norm.assign(norm.begin() + start, norm.begin() + end);
+        return result;
+    }
+};
+
+// ±[first, last)ʾеһΣԪ
+struct IndexRange {
+    int first, last;
+    int size() const { return last - first; }
+    bool empty() const { return first >= last; }
+};
+
+// ĩβ1ĸ
+inline int trailingOnes(unsigned int k) {
+#if defined(_MSC_VER)
+    unsigned long pos;
+    return _BitScanForward(&pos, ~k) ? (int)pos : 32;
+#else
+    return ~k ? __builtin_ctz(~k) : 32;
+#endif
+}
+
+// ģľ̬compareComplexźѸԪصģƽEytzingerBFS˳ţ
+// kĺ2k2k+1ֲǰͬһk8keys[8k..8k+7]ڣ
+// ռһУÿԤȡµҪõУ½޷ֻ֧ȽģƽֵnormThreshold
+// ģеʱ꣩lowerBound(orderedVec, m)ͬ
+class ModulusIndex {
+public:
+    ModulusIndex() : n(0), keys(nullptr) {}
+    explicit ModulusIndex(const vector<Complex>& orderedVec) : n(0), keys(nullptr) { build(orderedVec); }
+
+    // keysָstorageԱƺָԭڴ
+    ModulusIndex(const ModulusIndex&) = delete;
+    ModulusIndex& operator=(const ModulusIndex&) = delete;
+
+    void build(const vector<Complex>& orderedVec) {
+        n = orderedVec.size();
+        // keys[1..n]Ž㣬64ֽڶ룬ʹkeys[8k..8k+7]ռһ
+        storage.assign(n + 16, HUGE_VAL);
+        size_t offset = (64 - (size_t)storage.data() % 64) % 64 / sizeof(double);
+        keys = storage.data() + offset;
+        rank.assign(n + 1, n);
+        int next = 0;
+        fill(orderedVec, 1, next);
+    }
+
+    int size() const { return n; }
+
+    // һģ >= mԪص±꣬ڷsize()
+    int lowerBound(double m) const {
+        double t = normThreshold(m);
+        unsigned int k = 1;
+        while (k <= (unsigned int)n) {
+#if defined(__SSE2__) || defined(_M_X64) || defined(__AVX__)
+            _mm_prefetch((const char*)(keys + (size_t)k * 8), _MM_HINT_T0);
+#endif
+            k = 2 * k + (keys[k] < t);
+        }
+        // һߵĽǴ𰸣ȥĩβ""ȥһ""
+        k >>= trailingOnes(k) + 1;
+        return k == 0 ? n : rank[k];
+    }
+
+    // ңģ[m1, m2)Ԫص±
+    IndexRange rangeSearch(double m1, double m2) const {
+        int first = lowerBound(m1);
+        return { first, max(first, lowerBound(m2)) };
+    }
+
+private:
+    int n;
+    vector<double> storage;  // keysڵڴ棨
+    double* keys;            // keys[k]kģƽ
+    vector<int> rank;        // rank[k]kе±
+
+    // kηԪ
+    void fill(const vector<Complex>& orderedVec, int k, int& next) {
+        if (k > n) return;
+        fill(orderedVec, 2 * k, next);
+        const Complex& c = orderedVec[next];
+        keys[k] = c.getReal() * c.getReal() + c.getImag() * c.getImag();
+        rank[k] = next++;
+        fill(orderedVec, 2 * k + 1, next);
+    }
+};
+
+// ңranges[i] = {m1, m2}ظͼ
+// 2q˵㻻ģƽֵ򣬰С˳ζλÿ˵һ˵λó
+// ̽һڶ֣q˵ֻɨһ飬O(q log(n/q))
+// ģеʱ꣩rangeViewͬ
+vector<ComplexSpan> rangeViews(const vector<Complex>& orderedVec, const vector<pair<double, double>>& ranges) {
+    int n = orderedVec.size(), q = ranges.size();
+    auto normAt = [&orderedVec](int i) {
+        const Complex& c = orderedVec[i];
+        return c.getReal() * c.getReal() + c.getImag() * c.getImag();
+    };
+    vector<pair<double, int>> ends;  // (ֵ, ѯ*2 + ǷҶ˵)
+    ends.reserve(2 * q);
+    for (int i = 0; i < q; ++i) {
+        ends.emplace_back(normThreshold(ranges[i].first), 2 * i);
+        ends.emplace_back(normThreshold(ranges[i].second), 2 * i + 1);
+    }
+    sort(ends.begin(), ends.end());
+
+    vector<int> pos(2 * q);
+    int lo = 0;  // lo֮ǰԪģƽСڵǰֵ
+    for (const auto& e : ends) {
+        double t = e.first;
+        int bound = lo, step = 1;
+        while (bound < n && normAt(bound) < t) {
+            lo = bound + 1;
+            bound += step;
+            step *= 2;
+        }
+        int hi = min(bound, n);
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (normAt(mid) < t) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        pos[e.second] = lo;
+    }
+
+    vector<ComplexSpan> views(q);
+    for (int i = 0; i < q; ++i) {
+        int start = pos[2 * i], end = max(start, pos[2 * i + 1]);
+        views[i] = ComplexSpan(orderedVec.data() + start, orderedVec.data() + end);
+    }
+    return views;
+}
+
+// ϣƽ滮ֳɱ߳2*epsĸӣɢСĿȣoperator==֮Сepsֵ
+// ֻĿepsΧǵĸÿάӣ̽4ӣO(1)
+// Ͱʵֵhead/nextԱ߲߲롣ֵСԼ1e13Ų
+class ComplexHashIndex {
+public:
+    explicit ComplexHashIndex(int expected = 0) { rehash(max(expected, 8)); }
+
+    // vecؽiԪصıΪi
+    void build(const vector<Complex>& vec) {
+        values.clear();
+        next.clear();
+        rehash(max((int)vec.size(), 8));
+        for (const auto& c : vec) insert(c);
+    }
+
+    // һֵıţ˳0ʼ
+    int insert(const Complex& c) {
+        if (values.size() >= head.size()) rehash(head.size() * 2);
+        int id = values.size();
+        values.push_back(c);
+        int b = bucketOf(cellOf(c.getReal()), cellOf(c.getImag()));
+        next.push_back(head[b]);
+        head[b] = id;
+        return id;
+    }
+
+    // cȵԪбСһfindComplexĽͬڷ-1
+    int find(const Complex& c) const {
+        const double eps = 1e-6;
+        long long x0 = cellOf(c.getReal() - eps), x1 = cellOf(c.getReal() + eps);
+        long long y0 = cellOf(c.getImag() - eps), y1 = cellOf(c.getImag() + eps);
+        int found = -1;
+        for (long long x = x0; x <= x1; ++x) {
+            for (long long y = y0; y <= y1; ++y) {
+                // ˳򣬱ԽԽС
+                for (int id = head[bucketOf(x, y)]; id >= 0; id = next[id]) {
+                    if (values[id] == c && (found < 0 || id < found)) found = id;
+                }
+            }
+        }
+        return found;
+    }
+
+    int size() const { return values.size(); }
+
+private:
+    vector<int> head;       // ÿͰͷԪرţ
+    vector<int> next;       // ͬһͰڵһԪ
+    vector<Complex> values; // Ŵŵֵ
+
+    static long long cellOf(double v) { return (long long)floor(v / 2e-6); }
+
+    int bucketOf(long long x, long long y) const {
+        unsigned long long h = (unsigned long long)x * 0x9E3779B97F4A7C15ULL ^ (unsigned long long)y * 0xC2B2AE3D27D4EB4FULL;
+        h ^= h >> 32;
+        return (int)(h & (head.size() - 1));
+    }
+
+    // ͰȡСcapacity2ݣԪ¹ҵͰ
+    void rehash(int capacity) {
+        int buckets = 1;
+        while (buckets < capacity) buckets <<= 1;
+        head.assign(buckets, -1);
+        for (int id = 0; id < (int)values.size(); ++id) {
+            int b = bucketOf(cellOf(values[id].getReal()), cellOf(values[id].getImag()));
+            next[id] = head[b];
+            head[b] = id;
+        }
+    }
+};
+
+// ϣȥأÿֵѱֵһȽϣoperator==һγֵԪزԭ˳򣬲Ҫ
+vector<Complex> hashUnique(const vector<Complex>& vec) {
+    ComplexHashIndex index(vec.size());
     vector<Complex> result;
-    int start = lowerBound(orderedVec, m1);
-    int end = lowerBound(orderedVec, m2);
-    for (int i = start; i < end; ++i) {
-        result.push_back(orderedVec[i]);
+    for (const auto& c : vec) {
+        if (index.find(c) < 0) {
+            index.insert(c);
+            result.push_back(c);
+        }
     }
     return result;
 }
 
+// ƽϵʽk-d㰴(ʵ, 鲿)ţ[lo, hi)ĸеmid
+// [lo, mid)[mid + 1, hi)Ƚʵ鲿ָ֣룬ѯʱ˳ڴ档
+// KD_LEAFٻ֣ѯʱֱ顣ѯǵڽе±
+class ComplexKdTree {
+public:
+    ComplexKdTree() {}
+    ComplexKdTree(const vector<Complex>& vec, int numThreads = 1) { build(vec, numThreads); }
+
+    // nth_elementȡλO(n log n)ǰ߳̽
+    void build(const vector<Complex>& vec, int numThreads = 1) {
+        int n = vec.size();
+        pts.resize(n);
+        for (int i = 0; i < n; ++i) pts[i] = { vec[i].getReal(), vec[i].getImag(), i };
+        int threadDepth = 0;
+        while ((1 << threadDepth) < numThreads) threadDepth++;
+        buildRange(0, n, 0, threadDepth);
+    }
+
+    int size() const { return pts.size(); }
+
+    // ڣŷϾ룩ͬʱȡ±Сģ-1
+    int nearest(const Complex& q) const {
+        double best = HUGE_VAL;
+        int bestId = -1;
+        nearestRange(0, size(), 0, q.getReal(), q.getImag(), best, bestId);
+        return bestId;
+    }
+
+    // kڣ(, ±)ӽԶ
+    vector<int> kNearest(const Complex& q, int k) const {
+        vector<pair<double, int>> heap;  // (ƽ, ±)Ĵ󶥶ѣѶǵǰk
+        if (k > 0) {
+            heap.reserve(k + 1);
+            kNearestRange(0, size(), 0, q.getReal(), q.getImag(), k, heap);
+        }
+        sort_heap(heap.begin(), heap.end());
+        vector<int> ids;
+        ids.reserve(heap.size());
+        for (const auto& h : heap) ids.push_back(h.second);
+        return ids;
+    }
+
+    // βңʵ[xmin, xmax]鲿[ymin, ymax]ڵĵ
+    vector<int> rectangle(double xmin, double xmax, double ymin, double ymax) const {
+        vector<int> ids;
+        rectangleRange(0, size(), 0, xmin, xmax, ymin, ymax, ids);
+        return ids;
+    }
+
+    // Բңģ[m1, m2)ĵ㣨rangeSearchԼͬ
+    // ´ڵľΣεԭС벻Сm2Сm1ʱüȫԲʱ
+    vector<int> annulus(double m1, double m2) const {
+        vector<int> ids;
+        double t1 = normThreshold(m1), t2 = normThreshold(m2);
+        if (t1 < t2) annulusRange(0, size(), 0, t1, t2, -HUGE_VAL, HUGE_VAL, -HUGE_VAL, HUGE_VAL, ids);
+        return ids;
+    }
+
+    // ڣѯֳnumThreadsΣ̶߳
+    vector<int> nearestBatch(const vector<Complex>& queries, int numThreads = 1) const {
+        int q = queries.size();
+        vector<int> result(q);
+        numThreads = max(1, min(numThreads, q / 1024 + 1));
+        int chunk = (q + numThreads - 1) / numThreads;
+        vector<thread> workers;
+        for (int t = 0; t < numThreads; ++t) {
+            int lo = min(q, t * chunk), hi = min(q, lo + chunk);
+            workers.emplace_back([&, lo, hi]() {
+                for (int i = lo; i < hi; ++i) result[i] = nearest(queries[i]);
+            });
+        }
+        for (auto& w : workers) w.join();
+        return result;
+    }
+
+private:
+    struct KdPoint {
+        double x, y;
+        int id;
+    };
+    static const int KD_LEAF = 8;
+    vector<KdPoint> pts;
+
+    static double coord(const KdPoint& p, int depth) { return depth % 2 == 0 ? p.x : p.y; }
+
+    void buildRange(int lo, int hi, int depth, int threadDepth) {
+        if (hi - lo <= KD_LEAF) return;
+        int mid = lo + (hi - lo) / 2;
+        nth_element(pts.begin() + lo, pts.begin() + mid, pts.begin() + hi, [depth](const KdPoint& a, const KdPoint& b) {
+            return coord(a, depth) < coord(b, depth);
+        });
+        if (threadDepth > 0 && hi - lo > 65536) {
+            thread left([=]() { buildRange(lo, mid, depth + 1, threadDepth - 1); });
+            buildRange(mid + 1, hi, depth + 1, threadDepth - 1);
+            left.join();
+        }
+        else {
+            buildRange(lo, mid, depth + 1, 0);
+            buildRange(mid + 1, hi, depth + 1, 0);
+        }
+    }
+
+    static void consider(const KdPoint& p, double qx, double qy, double& best, int& bestId) {
+        double dx = p.x - qx, dy = p.y - qy;
+        double d = dx * dx + dy * dy;
+        if (d < best || (d == best && p.id < bestId)) {
+            best = d;
+            bestId = p.id;
+        }
+    }
+
+    // һĵ㵽ѯľƽСڵָߵľƽڵǰʱԼʱҪ±꣩
+    void nearestRange(int lo, int hi, int depth, double qx, double qy, double& best, int& bestId) const {
+        if (hi - lo <= KD_LEAF) {
+            for (int i = lo; i < hi; ++i) consider(pts[i], qx, qy, best, bestId);
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        consider(pts[mid], qx, qy, best, bestId);
+        double diff = (depth % 2 == 0 ? qx : qy) - coord(pts[mid], depth);
+        if (diff < 0) {
+            nearestRange(lo, mid, depth + 1, qx, qy, best, bestId);
+            if (diff * diff <= best) nearestRange(mid + 1, hi, depth + 1, qx, qy, best, bestId);
+        }
+        else {
+            nearestRange(mid + 1, hi, depth + 1, qx, qy, best, bestId);
+            if (diff * diff <= best) nearestRange(lo, mid, depth + 1, qx, qy, best, bestId);
+        }
+    }
+
+    static void offer(const KdPoint& p, double qx, double qy, int k, vector<pair<double, int>>& heap) {
+        double dx = p.x - qx, dy = p.y - qy;
+        pair<double, int> cand(dx * dx + dy * dy, p.id);
+        if ((int)heap.size() < k) {
+            heap.push_back(cand);
+            push_heap(heap.begin(), heap.end());
+        }
+        else if (cand < heap.front()) {
+            pop_heap(heap.begin(), heap.end());
+            heap.back() = cand;
+            push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    void kNearestRange(int lo, int hi, int depth, double qx, double qy, int k, vector<pair<double, int>>& heap) const {
+        if (hi - lo <= KD_LEAF) {
+            for (int i = lo; i < hi; ++i) offer(pts[i], qx, qy, k, heap);
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        offer(pts[mid], qx, qy, k, heap);
+        double diff = (depth % 2 == 0 ? qx : qy) - coord(pts[mid], depth);
+        int nearLo = lo, nearHi = mid, farLo = mid + 1, farHi = hi;
+        if (diff >= 0) {
+            swap(nearLo, farLo);
+            swap(nearHi, farHi);
+        }
+        kNearestRange(nearLo, nearHi, depth + 1, qx, qy, k, heap);
+        if ((int)heap.size() < k || diff * diff <= heap.front().first) {
+            kNearestRange(farLo, farHi, depth + 1, qx, qy, k, heap);
+        }
+    }
+
+    void rectangleRange(int lo, int hi, int depth, double xmin, double xmax, double ymin, double ymax, vector<int>& ids) const {
+        if (hi - lo <= KD_LEAF) {
+            for (int i = lo; i < hi; ++i) {
+                const KdPoint& p = pts[i];
+                if (p.x >= xmin && p.x <= xmax && p.y >= ymin && p.y <= ymax) ids.push_back(p.id);
+            }
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        const KdPoint& p = pts[mid];
+        if (p.x >= xmin && p.x <= xmax && p.y >= ymin && p.y <= ymax) ids.push_back(p.id);
+        double split = coord(p, depth);
+        // ĵ <= splitĵ >= split
+        if (split >= (depth % 2 == 0 ? xmin : ymin)) rectangleRange(lo, mid, depth + 1, xmin, xmax, ymin, ymax, ids);
+        if (split <= (depth % 2 == 0 ? xmax : ymax)) rectangleRange(mid + 1, hi, depth + 1, xmin, xmax, ymin, ymax, ids);
+    }
+
+    // [x0, x1][y0, y1]ԭƽ½Ͻ硣ľֵ֮䣬
+    // 뵥Ľÿģƽ
+    static double minNorm(double x0, double x1, double y0, double y1) {
+        double dx = x0 > 0 ? x0 : (x1 < 0 ? -x1 : 0);
+        double dy = y0 > 0 ? y0 : (y1 < 0 ? -y1 : 0);
+        return dx * dx + dy * dy;
+    }
+    static double maxNorm(double x0, double x1, double y0, double y1) {
+        double dx = max(fabs(x0), fabs(x1)), dy = max(fabs(y0), fabs(y1));
+        return dx * dx + dy * dy;
+    }
+
+    void annulusRange(int lo, int hi, int depth, double t1, double t2,
+        double x0, double x1, double y0, double y1, vector<int>& ids) const {
+        if (lo >= hi) return;
+        double inner = minNorm(x0, x1, y0, y1), outer = maxNorm(x0, x1, y0, y1);
+        if (inner >= t2 || outer < t1) return;
+        if (inner >= t1 && outer < t2) {
+            for (int i = lo; i < hi; ++i) ids.push_back(pts[i].id);
+            return;
+        }
+        if (hi - lo <= KD_LEAF) {
+            for (int i = lo; i < hi; ++i) {
+                double norm = pts[i].x * pts[i].x + pts[i].y * pts[i].y;
+                if (norm >= t1 && norm < t2) ids.push_back(pts[i].id);
+            }
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        const KdPoint& p = pts[mid];
+        double norm = p.x * p.x + p.y * p.y;
+        if (norm >= t1 && norm < t2) ids.push_back(p.id);
+        if (depth % 2 == 0) {
+            annulusRange(lo, mid, depth + 1, t1, t2, x0, p.x, y0, y1, ids);
+            annulusRange(mid + 1, hi, depth + 1, t1, t2, p.x, x1, y0, y1, ids);
+        }
+        else {
+            annulusRange(lo, mid, depth + 1, t1, t2, x0, x1, y0, p.y, ids);
+            annulusRange(mid + 1, hi, depth + 1, t1, t2, x0, x1, p.y, y1, ids);
+        }
+    }
+};
+
+// ֿ̬ԪذcompareComplex˳ɸУÿ鲻2*blockSize
+// ͬʱģƽȽʱ롢ɾȶֶλڿƶO(blockSize + log n)
+// ʱһΪСʱڿϲС״rankkСselectΪO(log n)
+class SortedComplexList {
+private:
+    struct Block {
+        vector<Complex> values;
+        vector<double> norms;  // values[i]ģƽ
+    };
+
+public:
+    // ֻ±
+    class const_iterator {
+    public:
+        const_iterator(const SortedComplexList* list = nullptr, int block = 0, int offset = 0)
+            : list(list), block(block), offset(offset) {}
+        const Complex& operator*() const { return list->blocks[block].values[offset]; }
+        const Complex* operator->() const { return &**this; }
+        const_iterator& operator++() {
+            if (++offset == (int)list->blocks[block].values.size()) {
+                ++block;
+                offset = 0;
+            }
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const { return block == other.block && offset == other.offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class SortedComplexList;
+        const SortedComplexList* list;
+        int block, offset;
+    };
+
+    // 䣬ֱڷΧfor
+    struct Range {
+        const_iterator first, last;
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+    };
+
+    explicit SortedComplexList(int blockSize = 512) : blockSize(blockSize), count(0) {}
+
+    int size() const { return count; }
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return const_iterator(this, blocks.size(), 0); }
+
+    // cȵԪ֮
+    void insert(const Complex& c) {
+        double norm = c.getReal() * c.getReal() + c.getImag() * c.getImag();
+        if (blocks.empty()) {
+            blocks.push_back(Block());
+            rebuildSizes();
+        }
+        // һĩԪc֮Ŀ飻ûŽһ
+        int lo = 0, hi = blocks.size() - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            const Block& b = blocks[mid];
+            if (lessByNorm(norm, c.getReal(), b.norms.back(), b.values.back().getReal())) hi = mid;
+            else lo = mid + 1;
+        }
+        Block& b = blocks[lo];
+        int pos = 0, last = b.values.size();
+        while (pos < last) {
+            int mid = (pos + last) / 2;
+            if (lessByNorm(norm, c.getReal(), b.norms[mid], b.values[mid].getReal())) last = mid;
+            else pos = mid + 1;
+        }
+        b.values.insert(b.values.begin() + pos, c);
+        b.norms.insert(b.norms.begin() + pos, norm);
+        count++;
+        if ((int)b.values.size() > 2 * blockSize) {
+            splitBlock(lo);
+        }
+        else {
+            addSize(lo, 1);
+        }
+    }
+
+    // ɾһcȣoperator==Ԫأû򷵻false
+    // ȵԪģ֮Сsqrt(2)*epsֻģcģ2e-6ڵһ
+    bool erase(const Complex& c) {
+        const_iterator it = lowerBound(c.mod() - 2e-6);
+        double t = normThreshold(c.mod() + 2e-6);
+        for (; it != end() && blocks[it.block].norms[it.offset] < t; ++it) {
+            if (*it == c) {
+                eraseAt(it.block, it.offset);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // kСԪأ0ʼ
+    const Complex& select(int k) const {
+        int b = findBlock(k);
+        return blocks[b].values[k];
+    }
+
+    // ģСmԪظlowerBound(toVector(), m)ͬ
+    int rank(double m) const {
+        const_iterator it = lowerBound(m);
+        return prefixSize(it.block) + it.offset;
+    }
+
+    // һģ >= mԪ
+    const_iterator lowerBound(double m) const {
+        double t = normThreshold(m);
+        int lo = 0, hi = blocks.size();
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (blocks[mid].norms.back() < t) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == (int)blocks.size()) return end();
+        const vector<double>& norms = blocks[lo].norms;
+        return const_iterator(this, lo, lower_bound(norms.begin(), norms.end(), t) - norms.begin());
+    }
+
+    // ңģ[m1, m2)Ԫأ
+    Range rangeSearch(double m1, double m2) const {
+        Range r = { lowerBound(m1), lowerBound(m2) };
+        if (r.last.block < r.first.block || (r.last.block == r.first.block && r.last.offset < r.first.offset)) {
+            r.last = r.first;
+        }
+        return r;
+    }
+
+    vector<Complex> toVector() const {
+        vector<Complex> vec;
+        vec.reserve(count);
+        for (const auto& b : blocks) vec.insert(vec.end(), b.values.begin(), b.values.end());
+        return vec;
+    }
+
+private:
+    int blockSize;
+    int count;
+    vector<Block> blocks;
+    vector<int> tree;  // С״飨±1ʼ
+
+    void addSize(int block, int delta) {
+        for (int i = block + 1; i < (int)tree.size(); i += i & -i) tree[i] += delta;
+    }
+
+    // ǰblockԪ
+    int prefixSize(int block) const {
+        int sum = 0;
+        for (int i = block; i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+
+    // kԪڵĿ飬kΪ±
+    int findBlock(int& k) const {
+        int pos = 0, step = 1;
+        while (step * 2 < (int)tree.size()) step *= 2;
+        for (; step > 0; step /= 2) {
+            if (pos + step < (int)tree.size() && tree[pos + step] <= k) {
+                pos += step;
+                k -= tree[pos];
+            }
+        }
+        return pos;
+    }
+
+    // 仯ؽ״飬O()
+    void rebuildSizes() {
+        tree.assign(blocks.size() + 1, 0);
+        for (int i = 1; i <= (int)blocks.size(); ++i) {
+            tree[i] += blocks[i - 1].values.size();
+            int parent = i + (i & -i);
+            if (parent <= (int)blocks.size()) tree[parent] += tree[i];
+        }
+    }
+
+    void splitBlock(int block) {
+        Block right;
+        Block& left = blocks[block];
+        int half = left.values.size() / 2;
+        right.values.assign(left.values.begin() + half, left.values.end());
+        right.norms.assign(left.norms.begin() + half, left.norms.end());
+        left.values.resize(half);
+        left.norms.resize(half);
+        blocks.insert(blocks.begin() + block + 1, move(right));
+        rebuildSizes();
+    }
+
+    void eraseAt(int block, int offset) {
+        Block& b = blocks[block];
+        b.values.erase(b.values.begin() + offset);
+        b.norms.erase(b.norms.begin() + offset);
+        count--;
+        // Сʱڿ飨ϲ󲻳2*blockSizeտֱɾȥ
+        int neighbor = block + 1 < (int)blocks.size() ? block + 1 : block - 1;
+        if (b.values.empty() || ((int)b.values.size() < blockSize / 4 && neighbor >= 0
+            && b.values.size() + blocks[neighbor].values.size() <= 2 * (size_t)blockSize)) {
+            if (!b.values.empty()) {
+                int first = min(block, neighbor);
+                Block& dst = blocks[first];
+                Block& src = blocks[first + 1];
+                dst.values.insert(dst.values.end(), src.values.begin(), src.values.end());
+                dst.norms.insert(dst.norms.end(), src.norms.begin(), src.norms.end());
+                block = first + 1;
+            }
+            blocks.erase(blocks.begin() + block);
+            rebuildSizes();
+        }
+        else {
+            addSize(block, -1);
+        }
+    }
+};
+
 int main() {
     srand(time(0));  // ʼ
 
@@ -247,6 +1081,14 @@ int main() {
     double mergeOrdered = testSortTime(mergeSort, orderedVec);
     double mergeReverse = testSortTime(mergeSort, reverseVec);
 
+    // ԵϹ鲢Ȼ鲢
+    double bottomUpRandom = testSortTime(bottomUpMergeSort, randomVec);
+    double bottomUpOrdered = testSortTime(bottomUpMergeSort, orderedVec);
+    double bottomUpReverse = testSortTime(bottomUpMergeSort, reverseVec);
+    double naturalRandom = testSortTime(naturalMergeSort, randomVec);
+    double naturalOrdered = testSortTime(naturalMergeSort, orderedVec);
+    double naturalReverse = testSortTime(naturalMergeSort, reverseVec);
+
     // 
     cout << fixed << setprecision(2);
     cout << "㷨 | (ms) | ˳(ms) | (ms)\n";
@@ -256,7 +1098,25 @@ int main() {
         << " | " << setw(12) << bubbleReverse << "\n";
     cout << "鲢 | " << setw(12) << mergeRandom
         << " | " << setw(12) << mergeOrdered
-        << " | " << setw(12) << mergeReverse << "\n\n";
+        << " | " << setw(12) << mergeReverse << "\n";
+    cout << "Ե | " << setw(12) << bottomUpRandom
+        << " | " << setw(12) << bottomUpOrdered
+        << " | " << setw(12) << bottomUpReverse << "\n";
+    cout << "Ȼ鲢 | " << setw(12) << naturalRandom
+        << " | " << setw(12) << naturalOrdered
+        << " | " << setw(12) << naturalReverse << "\n\n";
+
+    // ĲַȲռڴ
+    const int parallelSize = 10000000;
+    vector<Complex> stableVec = generateRandomVector(parallelSize, 10000);
+    vector<Complex> mergeVec = stableVec, sampleVec = stableVec;
+    double stableTime = testWallTime([](vector<Complex>& v) { stable_sort(v.begin(), v.end(), compareComplex); }, stableVec);
+    double parallelMergeTime = testWallTime([](vector<Complex>& v) { sortlib::parallelMergeSort(v.begin(), v.end(), compareComplex); }, mergeVec);
+    double sampleTime = testWallTime([](vector<Complex>& v) { sortlib::sampleSort(v.begin(), v.end(), compareComplex); }, sampleVec);
+    bool parallelSame = stableVec == mergeVec && stableVec == sampleVec;
+    vector<Complex>().swap(stableVec);
+    vector<Complex>().swap(mergeVec);
+    vector<Complex>().swap(sampleVec);
 
     // ֣
     cout << "===== ֣ =====" << endl;
@@ -269,13 +1129,280 @@ int main() {
 
     // ģ[2.0, 6.0)֮Ԫ
     double m1 = 2.0, m2 = 6.0;
-    vector<Complex> result = rangeSearch(searchVec, m1, m2);
+    ComplexSpan result = rangeView(searchVec, m1, m2);
 
     cout << "ģ[" << m1 << ", " << m2 << ")Ԫ: " << endl;
     for (const auto& c : result) {
         cout << c << " (ģ: " << setprecision(2) << c.mod() << ")  ";
     }
-    cout << endl;
+    cout << "\n" << endl;
+
+    // Ĳ֣
+    cout << "===== Ĳ֣" << parallelSize << "Ԫأ"
+        << max(1u, thread::hardware_concurrency()) << "̣߳=====" << endl;
+    cout << "stable_sort    | " << setw(10) << stableTime << " ms\n";
+    cout << "й鲢   | " << setw(10) << parallelMergeTime << " ms\n";
+    cout << "       | " << setw(10) << sampleTime << " ms\n";
+    cout << "һ: " << (parallelSame ? "" : "") << endl;
+
+    // 岿֣ԤģƽSoA
+    const int soaSize = 1000000, queryCount = 100000;
+    cout << "\n===== 岿֣SoA飨" << soaSize << "Ԫأ=====" << endl;
+    vector<Complex> aosVec = generateRandomVector(soaSize, 10000);
+    vector<Complex> soaInput = aosVec;
+    ComplexArray soa;
+    double aosSortTime = testWallTime([](vector<Complex>& v) { stable_sort(v.begin(), v.end(), compareComplex); }, aosVec);
+    double soaSortTime = testWallTime([&soa](vector<Complex>& v) { soa.assign(v); soa.sort(); }, soaInput);
+    bool sortSame = soa.toVector() == aosVec;
+
+    // ѯģ½磬ȽοԤģƽֲֶ
+    vector<double> queries(queryCount);
+    for (auto& q : queries) q = rand() % 14143 + rand() % 100 / 100.0;
+    vector<int> aosPos(queryCount), soaPos(queryCount);
+    double aosSearchTime = wallTime([&]() {
+        for (int i = 0; i < queryCount; ++i) aosPos[i] = lowerBound(aosVec, queries[i]);
+    });
+    double soaSearchTime = wallTime([&]() {
+        for (int i = 0; i < queryCount; ++i) soaPos[i] = soa.lowerBound(queries[i]);
+    });
+    bool searchSame = aosPos == soaPos;
+
+    cout << "                   | (ms)   | " << queryCount << "β(ms)\n";
+    cout << "vector<Complex>        | " << setw(10) << aosSortTime << " | " << setw(10) << aosSearchTime << "\n";
+    cout << "ComplexArray(ģƽ)   | " << setw(10) << soaSortTime << " | " << setw(10) << soaSearchTime << "\n";
+    cout << "һ: " << (sortSame ? "" : "") << "ҽһ: " << (searchSame ? "" : "") << endl;
+
+    // ֣ϣȥ
+    const int hashSize = 1000000, linearQueries = 1000, hashQueries = 1000000;
+    cout << "\n===== ֣ϣ" << hashSize << "Ԫأ=====" << endl;
+    vector<Complex> hashVec = generateRandomVector(hashSize, 2000);
+    vector<Complex> probes = generateRandomVector(hashQueries, 2000);
+    ComplexHashIndex index;
+    double buildTime = wallTime([&]() { index.build(hashVec); });
+
+    vector<int> linearPos(linearQueries), hashPos(hashQueries);
+    double linearTime = wallTime([&]() {
+        for (int i = 0; i < linearQueries; ++i) linearPos[i] = findComplex(hashVec, probes[i]);
+    });
+    double hashTime = wallTime([&]() {
+        for (int i = 0; i < hashQueries; ++i) hashPos[i] = index.find(probes[i]);
+    });
+    bool findSame = equal(linearPos.begin(), linearPos.end(), hashPos.begin());
+
+    // +uniqueϣȥأȽ߱Ԫ
+    vector<Complex> sortedUnique = hashVec;
+    double sortUniqueTime = testWallTime([](vector<Complex>& v) {
+        sort(v.begin(), v.end(), compareComplex);
+        v.erase(unique(v.begin(), v.end()), v.end());
+    }, sortedUnique);
+    vector<Complex> hashed;
+    double hashUniqueTime = wallTime([&]() { hashed = hashUnique(hashVec); });
+    sort(hashed.begin(), hashed.end(), compareComplex);
+    bool uniqueSame = hashed == sortedUnique;
+
+    cout << "                  | " << setw(10) << buildTime << " ms\n";
+    cout << "findComplex " << linearQueries << "         | " << setw(10) << linearTime << " ms\n";
+    cout << "ϣ " << hashQueries << "        | " << setw(10) << hashTime << " ms\n";
+    cout << "+unique               | " << setw(10) << sortUniqueTime << " ms\n";
+    cout << "ϣȥ                  | " << setw(10) << hashUniqueTime << " ms\n";
+    cout << "ҽһ: " << (findSame ? "" : "") << "ȥؽһ: " << (uniqueSame ? "" : "")
+        << "" << sortedUnique.size() << "" << endl;
+
+    // ߲֣Eytzingerֵģ
+    const int indexSize = 2000000, indexQueries = 1000000;
+    cout << "\n===== ߲֣ģľ̬" << indexSize << "Ԫأ=====" << endl;
+    vector<Complex> indexVec;
+    {
+        ComplexArray ordered(generateRandomVector(indexSize, 10000));
+        ordered.sort();
+        indexVec = ordered.toVector();
+        soa = ordered;
+    }
+    ModulusIndex modIndex;
+    double indexBuildTime = wallTime([&]() { modIndex.build(indexVec); });
+
+    vector<double> moduli(indexQueries);
+    for (auto& q : moduli) q = rand() % 14143 + rand() % 100 / 100.0;
+    vector<int> plainPos(indexQueries), normPos(indexQueries), eytzPos(indexQueries);
+    double plainTime = wallTime([&]() {
+        for (int i = 0; i < indexQueries; ++i) plainPos[i] = lowerBound(indexVec, moduli[i]);
+    });
+    double normTime = wallTime([&]() {
+        for (int i = 0; i < indexQueries; ++i) normPos[i] = soa.lowerBound(moduli[i]);
+    });
+    double eytzTime = wallTime([&]() {
+        for (int i = 0; i < indexQueries; ++i) eytzPos[i] = modIndex.lowerBound(moduli[i]);
+    });
+    IndexRange modRange = modIndex.rangeSearch(m1 * 1000, m2 * 1000);
+    bool indexSame = plainPos == normPos && plainPos == eytzPos
+        && modRange.first == lowerBound(indexVec, m1 * 1000) && modRange.last == lowerBound(indexVec, m2 * 1000);
+
+    cout << "                  | " << setw(10) << indexBuildTime << " ms\n";
+    cout << indexQueries << "β: lowerBound      | " << setw(10) << plainTime << " ms\n";
+    cout << indexQueries << "β: ģƽ  | " << setw(10) << normTime << " ms\n";
+    cout << indexQueries << "β: Eytzinger   | " << setw(10) << eytzTime << " ms\n";
+    cout << "ģ[" << m1 * 1000 << ", " << m2 * 1000 << ")Ԫ: ±[" << modRange.first << ", " << modRange.last
+        << ")" << modRange.size() << "\n";
+    cout << "ҽһ: " << (indexSame ? "" : "") << endl;
+
+    // ڰ˲֣ҷͼ
+    const int copyQueries = 20, viewQueries = 500;
+    cout << "\n===== ڰ˲֣ͼ" << indexSize << "Ԫأ" << viewQueries << "䣩=====" << endl;
+    vector<pair<double, double>> ranges(viewQueries);
+    for (auto& r : ranges) {
+        double a = rand() % 14143 + rand() % 100 / 100.0, b = rand() % 14143 + rand() % 100 / 100.0;
+        r = { min(a, b), max(a, b) };
+    }
+    vector<vector<Complex>> copies(copyQueries);
+    double copyTime = wallTime([&]() {
+        for (int i = 0; i < copyQueries; ++i) copies[i] = rangeSearch(indexVec, ranges[i].first, ranges[i].second);
+    });
+    vector<ComplexSpan> views(viewQueries);
+    double viewTime = wallTime([&]() {
+        for (int i = 0; i < viewQueries; ++i) views[i] = rangeView(indexVec, ranges[i].first, ranges[i].second);
+    });
+    vector<ComplexSpan> batched;
+    double batchTime = wallTime([&]() { batched = rangeViews(indexVec, ranges); });
+
+    bool viewSame = true;
+    long long matched = 0;
+    for (int i = 0; i < viewQueries; ++i) {
+        matched += views[i].size();
+        if (views[i].begin() != batched[i].begin() || views[i].end() != batched[i].end()) viewSame = false;
+        if (i < copyQueries && !equal(views[i].begin(), views[i].end(), copies[i].begin(), copies[i].end())) viewSame = false;
+    }
+    vector<vector<Complex>>().swap(copies);
+
+    cout << "rangeSearch() " << copyQueries << " | " << setw(10) << copyTime << " ms\n";
+    cout << "rangeView " << viewQueries << "        | " << setw(10) << viewTime << " ms\n";
+    cout << "rangeViews " << viewQueries << "   | " << setw(10) << batchTime << " ms\n";
+    cout << "ƽÿ" << matched / viewQueries << "Ԫأһ: " << (viewSame ? "" : "") << endl;
+
+    // ھŲ֣k-dɨȽϽ
+    const int kdSize = 1000000, kdQueries = 100000, kdChecks = 100, kNN = 10;
+    int kdThreads = max(1u, thread::hardware_concurrency());
+    cout << "\n===== ھŲ֣k-d" << kdSize << "㣬" << kdThreads << "̣߳=====" << endl;
+    vector<Complex> points = generateRandomVector(kdSize, 10000);
+    vector<Complex> kdProbes = generateRandomVector(kdQueries, 10000);
+    ComplexKdTree kd;
+    double kdBuildTime = wallTime([&]() { kd.build(points, kdThreads); });
+
+    auto dist2 = [&points](int i, const Complex& q) {
+        double dx = points[i].getReal() - q.getReal(), dy = points[i].getImag() - q.getImag();
+        return dx * dx + dy * dy;
+    };
+    bool kdSame = true;
+    double scanTime = wallTime([&]() {
+        for (int i = 0; i < kdChecks; ++i) {
+            int best = 0;
+            for (int j = 1; j < kdSize; ++j) if (dist2(j, kdProbes[i]) < dist2(best, kdProbes[i])) best = j;
+            if (best != kd.nearest(kdProbes[i])) kdSame = false;
+        }
+    });
+
+    vector<int> nearestIds(kdQueries);
+    double kdNearestTime = wallTime([&]() {
+        for (int i = 0; i < kdQueries; ++i) nearestIds[i] = kd.nearest(kdProbes[i]);
+    });
+    vector<int> batchIds;
+    double kdBatchTime = wallTime([&]() { batchIds = kd.nearestBatch(kdProbes, kdThreads); });
+    if (batchIds != nearestIds) kdSame = false;
+
+    long long kdFound = 0;
+    double kdKnnTime = wallTime([&]() {
+        for (int i = 0; i < kdQueries; ++i) kdFound += kd.kNearest(kdProbes[i], kNN).size();
+    });
+
+    // ΡԲkڸɴΣɨĽȽ
+    for (int i = 0; i < kdChecks; ++i) {
+        double cx = kdProbes[i].getReal(), cy = kdProbes[i].getImag(), half = 50 + i;
+        vector<int> rect = kd.rectangle(cx - half, cx + half, cy - half, cy + half), rectScan;
+        for (int j = 0; j < kdSize; ++j) {
+            double x = points[j].getReal(), y = points[j].getImag();
+            if (x >= cx - half && x <= cx + half && y >= cy - half && y <= cy + half) rectScan.push_back(j);
+        }
+        sort(rect.begin(), rect.end());
+        if (rect != rectScan) kdSame = false;
+
+        double r1 = i * 100.0, r2 = r1 + 3.5;
+        vector<int> ring = kd.annulus(r1, r2), ringScan;
+        for (int j = 0; j < kdSize; ++j) {
+            if (points[j].mod() >= r1 && points[j].mod() < r2) ringScan.push_back(j);
+        }
+        sort(ring.begin(), ring.end());
+        if (ring != ringScan) kdSame = false;
+
+        vector<pair<double, int>> all(kdSize);
+        for (int j = 0; j < kdSize; ++j) all[j] = { dist2(j, kdProbes[i]), j };
+        partial_sort(all.begin(), all.begin() + kNN, all.end());
+        vector<int> knn = kd.kNearest(kdProbes[i], kNN);
+        for (int j = 0; j < kNN; ++j) if (knn[j] != all[j].second) kdSame = false;
+    }
+
+    cout << "                          | " << setw(10) << kdBuildTime << " ms\n";
+    cout << "ɨ " << kdChecks << "            | " << setw(10) << scanTime << " ms\n";
+    cout << "k-d " << kdQueries << "          | " << setw(10) << kdNearestTime << " ms\n";
+    cout << "k-d " << kdQueries << "      | " << setw(10) << kdBatchTime << " ms\n";
+    cout << "k-d" << kNN << " " << kdQueries << "           | " << setw(10) << kdKnnTime << " ms\n";
+    cout << "һ: " << (kdSame ? "" : "") << "//Բ/kڸ" << kdChecks << "Σ" << endl;
+
+    // ʮ֣̬߲߲ѯɾһ룩
+    const int listSize = 1000000, vectorInserts = 100000, listQueries = 100000;
+    cout << "\n===== ʮ֣̬" << listSize << "β룩=====" << endl;
+    vector<Complex> stream = generateRandomVector(listSize, 10000);
+
+    // ĲҪƣֻǰvectorInserts
+    vector<Complex> sortedVec;
+    double vectorInsertTime = wallTime([&]() {
+        for (int i = 0; i < vectorInserts; ++i) {
+            sortedVec.insert(upper_bound(sortedVec.begin(), sortedVec.end(), stream[i], compareComplex), stream[i]);
+        }
+    });
+
+    SortedComplexList sortedList;
+    double listInsertTime = wallTime([&]() {
+        for (int i = 0; i < vectorInserts; ++i) sortedList.insert(stream[i]);
+    });
+    bool listSame = sortedList.toVector() == sortedVec;
+
+    // Ԫأÿ1000һ
+    long long streamed = 0;
+    double listStreamTime = wallTime([&]() {
+        for (int i = vectorInserts; i < listSize; ++i) {
+            sortedList.insert(stream[i]);
+            if (i % 1000 == 0) {
+                for (const auto& c : sortedList.rangeSearch(5000, 5001)) streamed += c.getReal() >= 0;
+            }
+        }
+    });
+
+    // kСչȽ
+    vector<Complex> flat = sortedList.toVector();
+    double rankSelectTime = wallTime([&]() {
+        for (int i = 0; i < listQueries; ++i) {
+            double m = rand() % 14143 + rand() % 100 / 100.0;
+            int k = (long long)rand() * rand() % listSize;
+            if (sortedList.rank(m) != lowerBound(flat, m) || !(sortedList.select(k) == flat[k])) listSame = false;
+        }
+    });
+
+    // ɾ±ΪżԪأʣµӦ±Ԫͬ
+    double listEraseTime = wallTime([&]() {
+        for (int i = 0; i < listSize; i += 2) {
+            if (!sortedList.erase(stream[i])) listSame = false;
+        }
+    });
+    vector<Complex> remaining;
+    for (int i = 1; i < listSize; i += 2) remaining.push_back(stream[i]);
+    stable_sort(remaining.begin(), remaining.end(), compareComplex);
+    if (sortedList.toVector() != remaining || sortedList.size() != (int)remaining.size()) listSame = false;
+
+    cout << " " << vectorInserts << "           | " << setw(10) << vectorInsertTime << " ms\n";
+    cout << " " << vectorInserts << "             | " << setw(10) << listInsertTime << " ms\n";
+    cout << "벢         | " << setw(10) << listStreamTime << " ms\n";
+    cout << "rank+select " << listQueries << "           | " << setw(10) << rankSelectTime << " msղң\n";
+    cout << "ɾ " << listSize / 2 << "            | " << setw(10) << listEraseTime << " ms\n";
+    cout << "һ: " << (listSame ? "" : "") << endl;
 
     return 0;
 }
@@ -1,33 +1,75 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <iostream>
-#include <stack>
 #include <string>
-#include <map>
 #include <cctype>
 #include <cmath>
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <chrono>
 
-// a op bĽpair(ǷЧ, )
-std::pair<bool, double> calculateOp(double a, double b, char op) {
+// ====================== ʽ ======================
+// ʽȱ沨RPNֽ룬ɽڶֵջִС
+// ͬһʽҪܶʱֻһΣ֮ÿֻһָɨַת
+
+// ָֽ
+enum OpCode : unsigned char {
+    OP_PUSH,  // ѹ볣constants[arg]
+    OP_LOAD,  // ѹvars[arg]
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV
+};
+
+struct Instruction {
+    OpCode op;
+    int arg;
+};
+
+// ĳ
+struct Program {
+    std::vector<Instruction> code;
+    std::vector<double> constants;
+    int maxDepth = 0;  // ִʱֵջ
+};
+
+// ȼ
+int priority(char op) {
     switch (op) {
-    case '+': return std::make_pair(true, a + b);
-    case '-': return std::make_pair(true, a - b);
-    case '*': return std::make_pair(true, a * b);
-    case '/':
-        if (fabs(b) < 1e-9) return std::make_pair(false, 0);  // Ϊ0Ǹȣ
-        return std::make_pair(true, a / b);
-    default: return std::make_pair(false, 0);
+    case '+': case '-': return 1;
+    case '*': case '/': return 2;
+    default: return 0;  // '('
     }
 }
 
-// ַĺ
-std::string calculate(const std::string& expr) {
-    std::stack<double> numStack;       // ջ
-    std::stack<char> opStack;          // ջ
-    std::map<char, int> priority = {   // ȼ
-        {'(', 0}, {'+', 1}, {'-', 1}, {'*', 2}, {'/' , 2}
-    };
+// Ӧָֵѹһֵջȼڱʱ
+bool emitOp(Program& prog, int& depth, char op) {
+    if (depth < 2) return false;
+    depth--;
+    switch (op) {
+    case '+': prog.code.push_back({ OP_ADD, 0 }); break;
+    case '-': prog.code.push_back({ OP_SUB, 0 }); break;
+    case '*': prog.code.push_back({ OP_MUL, 0 }); break;
+    case '/': prog.code.push_back({ OP_DIV, 0 }); break;
+    default: return false;
+    }
+    return true;
+}
+
+// ѹһֵ
+void emitPush(Program& prog, int& depth, OpCode op, int arg) {
+    prog.code.push_back({ op, arg });
+    prog.maxDepth = std::max(prog.maxDepth, ++depth);
+}
+
+// ѱʽֽ룬ʽЧʱfalse
+// variablesԳʽеıiִʱȡvars[i]еĸΪЧַ
+// Ϊ0ִֻʱ֣Ųƥ䡢ȱٲСȣڱʱ
+bool compileExpression(const std::string& expr, Program& prog, const std::vector<std::string>& variables = {}) {
+    prog = Program();
+    std::vector<char> opStack;  // ջ
+    int depth = 0;              // ִеǰλʱֵջ
     int n = expr.size();
     int i = 0;
 
@@ -46,52 +88,51 @@ std::string calculate(const std::string& expr) {
                 if (expr[j] == '.') {
                     dotCount++;
                     if (dotCount > 1) {  // СЧ
-                        return "ʽЧ";
+                        return false;
                     }
                 }
                 j++;
             }
-            // תַ֣
-            if (j == i) {  // ûЧ
-                return "ʽЧ";
-            }
-            std::string numStr = expr.substr(i, j - i);
             double num;
             try {
-                num = std::stod(numStr);
+                num = std::stod(expr.substr(i, j - i));
             }
             catch (...) {
-                return "ʽЧ";
+                return false;
             }
-            numStack.push(num);
+            prog.constants.push_back(num);
+            emitPush(prog, depth, OP_PUSH, prog.constants.size() - 1);
+            i = j;
+        }
+        // 
+        else if (isalpha(c) || c == '_') {
+            int j = i;
+            while (j < n && (isalnum(expr[j]) || expr[j] == '_')) j++;
+            auto it = std::find(variables.begin(), variables.end(), expr.substr(i, j - i));
+            if (it == variables.end()) {
+                return false;
+            }
+            emitPush(prog, depth, OP_LOAD, it - variables.begin());
             i = j;
         }
         // 
         else if (c == '(') {
-            opStack.push(c);
+            opStack.push_back(c);
             i++;
         }
         // 
         else if (c == ')') {
             // ֱ
-            while (!opStack.empty() && opStack.top() != '(') {
-                char op = opStack.top();
-                opStack.pop();
-                if (numStack.size() < 2) {
-                    return "ʽЧ";
+            while (!opStack.empty() && opStack.back() != '(') {
+                if (!emitOp(prog, depth, opStack.back())) {
+                    return false;
                 }
-                double b = numStack.top(); numStack.pop();
-                double a = numStack.top(); numStack.pop();
-                std::pair<bool, double> resPair = calculateOp(a, b, op);
-                if (!resPair.first) {
-                    return "ʽЧ";
-                }
-                numStack.push(resPair.second);
+                opStack.pop_back();
             }
             if (opStack.empty()) {  // ƥ
-                return "ʽЧ";
+                return false;
             }
-            opStack.pop();  // 
+            opStack.pop_back();  // 
             i++;
         }
         // 
@@ -100,59 +141,75 @@ std::string calculate(const std::string& expr) {
             if (c == '-' && (i == 0 || expr[i - 1] == '(' ||
                 expr[i - 1] == '+' || expr[i - 1] == '-' ||
                 expr[i - 1] == '*' || expr[i - 1] == '/')) {
-                numStack.push(0.0);  // ŵȼ0 - 
+                prog.constants.push_back(0.0);  // ŵȼ0 - 
+                emitPush(prog, depth, OP_PUSH, prog.constants.size() - 1);
             }
             // ȼȼ
-            while (!opStack.empty() && opStack.top() != '(' &&
-                priority[c] <= priority[opStack.top()]) {
-                char op = opStack.top();
-                opStack.pop();
-                if (numStack.size() < 2) {
-                    return "ʽЧ";
-                }
-                double b = numStack.top(); numStack.pop();
-                double a = numStack.top(); numStack.pop();
-                std::pair<bool, double> resPair = calculateOp(a, b, op);
-                if (!resPair.first) {
-                    return "ʽЧ";
+            while (!opStack.empty() && opStack.back() != '(' &&
+                priority(c) <= priority(opStack.back())) {
+                if (!emitOp(prog, depth, opStack.back())) {
+                    return false;
                 }
-                numStack.push(resPair.second);
+                opStack.pop_back();
             }
-            opStack.push(c);
+            opStack.push_back(c);
             i++;
         }
         // Чַ
         else {
-            return "ʽЧ";
+            return false;
         }
     }
 
     // ʣ
     while (!opStack.empty()) {
-        char op = opStack.top();
-        opStack.pop();
-        if (op == '(') {  // δƥ
-            return "ʽЧ";
+        if (opStack.back() == '(') {  // δƥ
+            return false;
         }
-        if (numStack.size() < 2) {
-            return "ʽЧ";
+        if (!emitOp(prog, depth, opStack.back())) {
+            return false;
         }
-        double b = numStack.top(); numStack.pop();
-        double a = numStack.top(); numStack.pop();
-        std::pair<bool, double> resPair = calculateOp(a, b, op);
-        if (!resPair.first) {
-            return "ʽЧ";
-        }
-        numStack.push(resPair.second);
+        opStack.pop_back();
     }
 
     // ǷΨһ
-    if (numStack.size() != 1) {
-        return "ʽЧ";
+    return depth == 1;
+}
+
+// ====================== ֽ ======================
+const int STACK_LIMIT = 64;  // ջȲֵʱֵջںջ֡
+
+// ִбɹĳ򣬳Ϊ0Ǹȣʱfalse
+bool runProgram(const Program& prog, const double* vars, double& result) {
+    double local[STACK_LIMIT];
+    std::vector<double> heap;
+    double* stack = local;
+    if (prog.maxDepth > STACK_LIMIT) {  // Ƕ׺ʽӲҪ
+        heap.resize(prog.maxDepth);
+        stack = heap.data();
     }
+    const double* constants = prog.constants.data();
+    int top = -1;
+    for (const Instruction& ins : prog.code) {
+        switch (ins.op) {
+        case OP_PUSH: stack[++top] = constants[ins.arg]; break;
+        case OP_LOAD: stack[++top] = vars[ins.arg]; break;
+        case OP_ADD: stack[top - 1] += stack[top]; top--; break;
+        case OP_SUB: stack[top - 1] -= stack[top]; top--; break;
+        case OP_MUL: stack[top - 1] *= stack[top]; top--; break;
+        case OP_DIV:
+            if (fabs(stack[top]) < 1e-9) return false;
+            stack[top - 1] /= stack[top];
+            top--;
+            break;
+        }
+    }
+    result = stack[0];
+    return true;
+}
 
-    // ʾȥ.0
-    double result = numStack.top();
+// ʽȥС֣ȥĩβ0
+std::string formatResult(double result) {
     if (fabs(result - round(result)) < 1e-9) {  // 
         return std::to_string(static_cast<long long>(round(result)));
     }
@@ -167,6 +224,16 @@ std::string calculate(const std::string& expr) {
     }
 }
 
+// ַĺִ
+std::string calculate(const std::string& expr) {
+    Program prog;
+    double result;
+    if (!compileExpression(expr, prog) || !runProgram(prog, nullptr, result)) {
+        return "ʽЧ";
+    }
+    return formatResult(result);
+}
+
 // 
 int main() {
     // Чʽ
@@ -209,5 +276,44 @@ int main() {
         std::cout << expr << " = " << calculate(expr) << std::endl;
     }
 
+    // ͬһʽӷ㣺ÿcalculate½һκִֻֽ
+    const int repeat = 1000000;
+    const std::string formula = "(10 + 20)*(30-25)/5 - 1.5*(2+3)";
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string text;
+    for (int k = 0; k < repeat; ++k) text = calculate(formula);
+    auto end = std::chrono::high_resolution_clock::now();
+    double parseTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+    Program prog;
+    if (!compileExpression(formula, prog)) return 1;
+    double value = 0, sum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < repeat; ++k) {
+        runProgram(prog, nullptr, value);
+        sum += value;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double runTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+    // ʽӣһΣÿδ벻ͬxy
+    Program varProg;
+    if (!compileExpression("(x + 1) * (y - 2) / 4 - (-x)", varProg, { "x", "y" })) return 1;
+    bool varSame = true;
+    start = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < repeat; ++k) {
+        double vars[2] = { k * 0.5, k % 7 + 3.0 };
+        double r;
+        if (!runProgram(varProg, vars, r) || r != (vars[0] + 1) * (vars[1] - 2) / 4 - (0 - vars[0])) varSame = false;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double varTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+    std::cout << "\nظԣ" << repeat << "Σ" << std::endl;
+    std::cout << formula << " = " << text << std::endl;
+    std::cout << "ÿν: " << parseTime << "ms | һκִ: " << runTime << "ms | һ: "
+        << (formatResult(sum / repeat) == text ? "" : "") << std::endl;
+    std::cout << "ʽִ: " << varTime << "ms | ֱӼһ: " << (varSame ? "" : "") << std::endl;
+
     return 0;
 }
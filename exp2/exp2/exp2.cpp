@@ -5,6 +5,23 @@
 #include <vector>
 #include <queue>
 #include <map>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 // 定义秩类型
@@ -47,7 +64,7 @@ public:
             fclose(fp);
         }
 
-        for (Rank k = 0, _sz = 0; k < n; k++) {
+        for (Rank k = 0; k < n; k++) {
             _sz += test(k) ? 1 : 0;
         }
     }
@@ -83,7 +100,7 @@ public:
 
 
     bool test(Rank k) {
-        expand(k);
+        if (k >= 8 * N) return false;
         return M[k >> 3] & (0x80 >> (k & 0x07));
     }
 
@@ -108,14 +125,896 @@ public:
 };
 
 
+// ====================== 字级位图：64 位字存储，支持 popcount、rank/select 与批量运算 ======================
+// 单字内置位数，优先使用硬件 popcnt
+static inline int popcount64(unsigned long long x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return (int)__popcnt64(x);
+#elif defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 单字内第 r 个（从 0 计）置位位的位置
+static inline int selectInWord(unsigned long long x, int r) {
+    for (int b = 0; b < 64; b += 8) {
+        int c = popcount64((x >> b) & 0xFF);
+        if (r < c) {
+            for (int i = b;; i++) {
+                if ((x >> i) & 1) {
+                    if (r == 0) return i;
+                    r--;
+                }
+            }
+        }
+        r -= c;
+    }
+    return -1;
+}
+
+// 字节内位序翻转：Bitmap 文件格式为字节内高位在前，WordBitmap 为字内低位在前
+static inline unsigned char reverseByte(unsigned char b) {
+    b = (unsigned char)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+    b = (unsigned char)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+    b = (unsigned char)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+    return b;
+}
+
+class WordBitmap {
+private:
+    static const int BLOCK_WORDS = 8;        // rank 目录每 512 位记一次累计数
+    static const int SELECT_SAMPLE = 4096;   // select 目录每 4096 个置位位采样一次
+
+    vector<unsigned long long> W;   // 第 k 位位于 W[k >> 6] 的第 (k & 63) 位
+    Rank _sz;                       // 置位位总数
+
+    // rank/select 目录，位图修改后失效，查询时按需重建
+    mutable vector<unsigned int> blockRank;   // 各 512 位块之前的置位位数
+    mutable vector<unsigned int> selectHint;  // 第 i*SELECT_SAMPLE 个置位位所在块号
+    mutable bool indexValid;
+
+    void expand(Rank k) {
+        if (k < capacity()) return;
+        W.resize((size_t)(2 * (long long)k / 64 + 1), 0);
+        indexValid = false;
+    }
+
+    void buildIndex() const {
+        Rank blocks = (W.size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+        blockRank.assign(blocks + 1, 0);
+        selectHint.clear();
+        unsigned int cnt = 0;
+        for (Rank b = 0; b < blocks; b++) {
+            blockRank[b] = cnt;
+            Rank end = min((Rank)W.size(), (b + 1) * BLOCK_WORDS);
+            for (Rank w = b * BLOCK_WORDS; w < end; w++) {
+                unsigned int c = popcount64(W[w]);
+                // 本字跨过了下一个采样点
+                while (cnt + c > selectHint.size() * (unsigned int)SELECT_SAMPLE) selectHint.push_back(b);
+                cnt += c;
+            }
+        }
+        blockRank[blocks] = cnt;
+        indexValid = true;
+    }
+
+    void recount() {
+        _sz = 0;
+        for (unsigned long long w : W) _sz += popcount64(w);
+        indexValid = false;
+    }
+
+public:
+    WordBitmap(Rank n = 64) : W(((size_t)n + 63) / 64, 0), _sz(0), indexValid(false) {}
+
+    // 读入 Bitmap::dump 写出的文件（字节内高位在前）
+    WordBitmap(char* file, Rank n = 64) : W(((size_t)n + 63) / 64, 0), _sz(0), indexValid(false) {
+        FILE* fp = fopen(file, "rb");
+        if (fp) {
+            vector<unsigned char> bytes(((size_t)n + 7) / 8, 0);
+            size_t got = fread(bytes.data(), 1, bytes.size(), fp);
+            fclose(fp);
+            for (size_t i = 0; i < got; i++) {
+                W[i >> 3] |= (unsigned long long)reverseByte(bytes[i]) << ((i & 7) * 8);
+            }
+        }
+        recount();
+    }
+
+    Rank size() const { return _sz; }
+    // 位数可超过 Rank 的范围（k ≥ 2^30 扩容后字数 × 64 会超过 2^31），用 long long
+    long long capacity() const { return (long long)W.size() * 64; }
+
+    // 负编号忽略
+    void set(Rank k) {
+        if (k < 0) return;
+        expand(k);
+        unsigned long long mask = 1ULL << (k & 63);
+        if (!(W[k >> 6] & mask)) {
+            W[k >> 6] |= mask;
+            _sz++;
+            indexValid = false;
+        }
+    }
+
+    // 越界位本就为 0，无需扩容
+    void clear(Rank k) {
+        if (k < 0 || k >= capacity()) return;
+        unsigned long long mask = 1ULL << (k & 63);
+        if (W[k >> 6] & mask) {
+            W[k >> 6] &= ~mask;
+            _sz--;
+            indexValid = false;
+        }
+    }
+
+    // 只读查询，越界返回 false，不会扩容
+    bool test(Rank k) const {
+        return k >= 0 && k < capacity() && ((W[k >> 6] >> (k & 63)) & 1);
+    }
+
+    // [0, k) 中置位位数：块累计数 + 至多 8 次 popcount
+    Rank rank(Rank k) const {
+        if (!indexValid) buildIndex();
+        if (k >= capacity()) return _sz;
+        Rank w = k >> 6;
+        Rank b = w / BLOCK_WORDS;
+        Rank r = blockRank[b];
+        for (Rank i = b * BLOCK_WORDS; i < w; i++) r += popcount64(W[i]);
+        if (k & 63) r += popcount64(W[w] & ((1ULL << (k & 63)) - 1));
+        return r;
+    }
+
+    // 第 j 个（从 0 计）置位位的位置，不存在时返回 -1
+    Rank select(Rank j) const {
+        if (j < 0 || j >= _sz) return -1;
+        if (!indexValid) buildIndex();
+        // 采样点确定块区间，区间内二分块累计数
+        Rank lo = selectHint[j / SELECT_SAMPLE];
+        Rank hi = (Rank)(j / SELECT_SAMPLE + 1 < (Rank)selectHint.size() ? selectHint[j / SELECT_SAMPLE + 1] : blockRank.size() - 2);
+        while (lo < hi) {
+            Rank mid = lo + (hi - lo + 1) / 2;
+            if (blockRank[mid] <= (unsigned int)j) lo = mid;
+            else hi = mid - 1;
+        }
+        Rank r = j - blockRank[lo];
+        for (Rank w = lo * BLOCK_WORDS;; w++) {
+            int c = popcount64(W[w]);
+            if (r < c) return w * 64 + selectInWord(W[w], r);
+            r -= c;
+        }
+    }
+
+    // 按字批量运算，结果写回自身
+    void andWith(const WordBitmap& other) {
+        size_t n = min(W.size(), other.W.size());
+        for (size_t i = 0; i < n; i++) W[i] &= other.W[i];
+        for (size_t i = n; i < W.size(); i++) W[i] = 0;
+        recount();
+    }
+
+    void orWith(const WordBitmap& other) {
+        if (W.size() < other.W.size()) W.resize(other.W.size(), 0);
+        for (size_t i = 0; i < other.W.size(); i++) W[i] |= other.W[i];
+        recount();
+    }
+
+    void xorWith(const WordBitmap& other) {
+        if (W.size() < other.W.size()) W.resize(other.W.size(), 0);
+        for (size_t i = 0; i < other.W.size(); i++) W[i] ^= other.W[i];
+        recount();
+    }
+
+    void andNotWith(const WordBitmap& other) {
+        size_t n = min(W.size(), other.W.size());
+        for (size_t i = 0; i < n; i++) W[i] &= ~other.W[i];
+        recount();
+    }
+
+    // 写出与 Bitmap::dump 相同的文件格式
+    void dump(char* file) const {
+        FILE* fp = fopen(file, "wb");
+        if (fp) {
+            vector<unsigned char> bytes(W.size() * 8);
+            for (size_t i = 0; i < bytes.size(); i++) {
+                bytes[i] = reverseByte((unsigned char)(W[i >> 3] >> ((i & 7) * 8)));
+            }
+            fwrite(bytes.data(), 1, bytes.size(), fp);
+            fclose(fp);
+        }
+    }
+
+    char* bits2string(Rank n) const {
+        char* s = new char[n + 1];
+        s[n] = '\0';
+        for (Rank i = 0; i < n; i++) {
+            s[i] = test(i) ? '1' : '0';
+        }
+        return s;
+    }
+};
+
+
+// ====================== 压缩位图：Roaring 风格的分块容器 ======================
+// 32 位编号按高 16 位分块，每块按数据分布选用数组、位集或游程容器
+struct RoaringContainer {
+    enum Type { ARRAY, BITSET, RUN };
+    static const int ARRAY_MAX = 4096;     // 数组容器上限，超过后位集更省空间
+    static const int WORDS = 1024;         // 位集容器 65536 位
+
+    Type type;
+    int card;                              // 基数
+    vector<unsigned short> arr;            // ARRAY：有序低 16 位
+    vector<unsigned long long> bits;       // BITSET
+    vector<unsigned short> runs;           // RUN：成对存放 (起点, 长度-1)
+
+    RoaringContainer() : type(ARRAY), card(0) {}
+
+    bool contains(unsigned short x) const {
+        if (type == ARRAY) return binary_search(arr.begin(), arr.end(), x);
+        if (type == BITSET) return (bits[x >> 6] >> (x & 63)) & 1;
+        // 找最后一个起点 <= x 的游程
+        int lo = 0, hi = (int)runs.size() / 2 - 1, hit = -1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            if (runs[2 * mid] <= x) { hit = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+        return hit >= 0 && x - runs[2 * hit] <= runs[2 * hit + 1];
+    }
+
+    // 展开为 1024 个字
+    void toWords(vector<unsigned long long>& w) const {
+        if (type == BITSET) { w = bits; return; }
+        w.assign(WORDS, 0);
+        if (type == ARRAY) {
+            for (unsigned short x : arr) w[x >> 6] |= 1ULL << (x & 63);
+            return;
+        }
+        for (size_t i = 0; i < runs.size(); i += 2) {
+            for (int x = runs[i]; x <= runs[i] + runs[i + 1]; x++) w[x >> 6] |= 1ULL << (x & 63);
+        }
+    }
+
+    // 由字数组构造，按序列化字节数取最小的表示：数组 2*card，位集 8192，游程 4*runs
+    static RoaringContainer fromWords(const vector<unsigned long long>& w) {
+        RoaringContainer c;
+        int card = 0, nRuns = 0;
+        unsigned long long carry = 0;  // 上一字最高位
+        for (int i = 0; i < WORDS; i++) {
+            card += popcount64(w[i]);
+            nRuns += popcount64(w[i] & ~((w[i] << 1) | carry));
+            carry = w[i] >> 63;
+        }
+        c.card = card;
+        int arrBytes = 2 * card, runBytes = 4 * nRuns, bitBytes = WORDS * 8;
+        if (runBytes < arrBytes && runBytes < bitBytes) {
+            c.type = RUN;
+            for (int x = 0; x < 65536;) {
+                if (!((w[x >> 6] >> (x & 63)) & 1)) {
+                    // 跳过全零字
+                    if ((x & 63) == 0 && w[x >> 6] == 0) x += 64; else x++;
+                    continue;
+                }
+                int start = x;
+                while (x < 65536 && ((w[x >> 6] >> (x & 63)) & 1)) x++;
+                c.runs.push_back((unsigned short)start);
+                c.runs.push_back((unsigned short)(x - 1 - start));
+            }
+        }
+        else if (card <= ARRAY_MAX) {
+            c.type = ARRAY;
+            c.arr.reserve(card);
+            for (int i = 0; i < WORDS; i++) {
+                for (unsigned long long v = w[i]; v; v &= v - 1) {
+                    c.arr.push_back((unsigned short)(i * 64 + selectInWord(v, 0)));
+                }
+            }
+        }
+        else {
+            c.type = BITSET;
+            c.bits = w;
+        }
+        return c;
+    }
+
+    // 游程容器修改前先展开为数组或位集
+    void unpackRun() {
+        if (type != RUN) return;
+        vector<unsigned long long> w;
+        toWords(w);
+        runs.clear();
+        if (card <= ARRAY_MAX) {
+            type = ARRAY;
+            for (int i = 0; i < WORDS; i++) {
+                for (unsigned long long v = w[i]; v; v &= v - 1) arr.push_back((unsigned short)(i * 64 + selectInWord(v, 0)));
+            }
+        }
+        else {
+            type = BITSET;
+            bits = w;
+        }
+    }
+
+    // 插入成功返回 true；数组超过上限时转为位集
+    bool add(unsigned short x) {
+        unpackRun();
+        if (type == BITSET) {
+            unsigned long long mask = 1ULL << (x & 63);
+            if (bits[x >> 6] & mask) return false;
+            bits[x >> 6] |= mask;
+            card++;
+            return true;
+        }
+        auto it = lower_bound(arr.begin(), arr.end(), x);
+        if (it != arr.end() && *it == x) return false;
+        arr.insert(it, x);
+        card++;
+        if (card > ARRAY_MAX) {
+            vector<unsigned long long> w;
+            toWords(w);
+            arr.clear();
+            arr.shrink_to_fit();
+            type = BITSET;
+            bits = w;
+        }
+        return true;
+    }
+
+    // 删除成功返回 true；位集降到上限以下时转回数组
+    bool remove(unsigned short x) {
+        unpackRun();
+        if (type == BITSET) {
+            unsigned long long mask = 1ULL << (x & 63);
+            if (!(bits[x >> 6] & mask)) return false;
+            bits[x >> 6] &= ~mask;
+            if (--card <= ARRAY_MAX) *this = fromWords(bits);
+            return true;
+        }
+        auto it = lower_bound(arr.begin(), arr.end(), x);
+        if (it == arr.end() || *it != x) return false;
+        arr.erase(it);
+        card--;
+        return true;
+    }
+
+    // 交集：有数组参与时逐个探测，否则按字与
+    static RoaringContainer intersect(const RoaringContainer& a, const RoaringContainer& b) {
+        if (a.type == ARRAY || b.type == ARRAY) {
+            const RoaringContainer& arrSide = a.type == ARRAY ? a : b;
+            const RoaringContainer& other = a.type == ARRAY ? b : a;
+            RoaringContainer c;
+            if (other.type == ARRAY) {
+                set_intersection(arrSide.arr.begin(), arrSide.arr.end(), other.arr.begin(), other.arr.end(), back_inserter(c.arr));
+            }
+            else {
+                for (unsigned short x : arrSide.arr) if (other.contains(x)) c.arr.push_back(x);
+            }
+            c.card = c.arr.size();
+            return c;
+        }
+        vector<unsigned long long> wa, wb;
+        a.toWords(wa);
+        b.toWords(wb);
+        for (int i = 0; i < WORDS; i++) wa[i] &= wb[i];
+        return fromWords(wa);
+    }
+
+    // 并集：两个小数组直接归并，否则按字或
+    static RoaringContainer unite(const RoaringContainer& a, const RoaringContainer& b) {
+        if (a.type == ARRAY && b.type == ARRAY && a.card + b.card <= ARRAY_MAX) {
+            RoaringContainer c;
+            set_union(a.arr.begin(), a.arr.end(), b.arr.begin(), b.arr.end(), back_inserter(c.arr));
+            c.card = c.arr.size();
+            return c;
+        }
+        vector<unsigned long long> wa, wb;
+        a.toWords(wa);
+        b.toWords(wb);
+        for (int i = 0; i < WORDS; i++) wa[i] |= wb[i];
+        return fromWords(wa);
+    }
+
+    size_t sizeInBytes() const {
+        return arr.capacity() * 2 + bits.capacity() * 8 + runs.capacity() * 2 + sizeof(*this);
+    }
+};
+
+class RoaringBitmap {
+private:
+    vector<unsigned short> keys;           // 有序高 16 位
+    vector<RoaringContainer> containers;   // 与 keys 一一对应
+    long long _sz;
+
+    // 高 16 位所在下标，不存在时返回 -1
+    int findKey(unsigned short hi) const {
+        auto it = lower_bound(keys.begin(), keys.end(), hi);
+        if (it == keys.end() || *it != hi) return -1;
+        return it - keys.begin();
+    }
+
+    // 小端序读写，保证序列化格式与平台无关
+    static void putU16(vector<unsigned char>& out, unsigned int v) {
+        out.push_back((unsigned char)v);
+        out.push_back((unsigned char)(v >> 8));
+    }
+    static void putU32(vector<unsigned char>& out, unsigned int v) {
+        putU16(out, v & 0xFFFF);
+        putU16(out, v >> 16);
+    }
+    static unsigned int getU16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+    static unsigned int getU32(const unsigned char* p) { return getU16(p) | (getU16(p + 2) << 16); }
+
+public:
+    RoaringBitmap() : _sz(0) {}
+
+    // 读入 dump 写出的文件，格式不符时得到空位图
+    RoaringBitmap(char* file) : _sz(0) {
+        FILE* fp = fopen(file, "rb");
+        if (!fp) return;
+        vector<unsigned char> buf;
+        unsigned char tmp[4096];
+        size_t got;
+        while ((got = fread(tmp, 1, sizeof(tmp), fp)) > 0) buf.insert(buf.end(), tmp, tmp + got);
+        fclose(fp);
+        deserialize(buf);
+    }
+
+    long long size() const { return _sz; }
+
+    void set(unsigned int k) {
+        unsigned short hi = k >> 16;
+        auto it = lower_bound(keys.begin(), keys.end(), hi);
+        int i = it - keys.begin();
+        if (it == keys.end() || *it != hi) {
+            keys.insert(it, hi);
+            containers.insert(containers.begin() + i, RoaringContainer());
+        }
+        if (containers[i].add((unsigned short)k)) _sz++;
+    }
+
+    void clear(unsigned int k) {
+        int i = findKey(k >> 16);
+        if (i < 0) return;
+        if (containers[i].remove((unsigned short)k)) {
+            _sz--;
+            if (containers[i].card == 0) {
+                keys.erase(keys.begin() + i);
+                containers.erase(containers.begin() + i);
+            }
+        }
+    }
+
+    bool test(unsigned int k) const {
+        int i = findKey(k >> 16);
+        return i >= 0 && containers[i].contains((unsigned short)k);
+    }
+
+    // 各容器重新选择最省空间的表示（批量插入后调用可把连续区间压成游程）
+    void optimize() {
+        vector<unsigned long long> w;
+        for (auto& c : containers) {
+            c.toWords(w);
+            c = RoaringContainer::fromWords(w);
+        }
+    }
+
+    // 按键归并，只对两侧都有的块求交
+    static RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap r;
+        size_t i = 0, j = 0;
+        while (i < a.keys.size() && j < b.keys.size()) {
+            if (a.keys[i] < b.keys[j]) i++;
+            else if (a.keys[i] > b.keys[j]) j++;
+            else {
+                RoaringContainer c = RoaringContainer::intersect(a.containers[i], b.containers[j]);
+                if (c.card > 0) {
+                    r._sz += c.card;
+                    r.keys.push_back(a.keys[i]);
+                    r.containers.push_back(c);
+                }
+                i++;
+                j++;
+            }
+        }
+        return r;
+    }
+
+    static RoaringBitmap unite(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap r;
+        size_t i = 0, j = 0;
+        while (i < a.keys.size() || j < b.keys.size()) {
+            if (j == b.keys.size() || (i < a.keys.size() && a.keys[i] < b.keys[j])) {
+                r.keys.push_back(a.keys[i]);
+                r.containers.push_back(a.containers[i++]);
+            }
+            else if (i == a.keys.size() || b.keys[j] < a.keys[i]) {
+                r.keys.push_back(b.keys[j]);
+                r.containers.push_back(b.containers[j++]);
+            }
+            else {
+                r.keys.push_back(a.keys[i]);
+                r.containers.push_back(RoaringContainer::unite(a.containers[i++], b.containers[j++]));
+            }
+            r._sz += r.containers.back().card;
+        }
+        return r;
+    }
+
+    size_t sizeInBytes() const {
+        size_t bytes = keys.capacity() * 2;
+        for (auto& c : containers) bytes += c.sizeInBytes();
+        return bytes;
+    }
+
+    // 序列化格式（小端）："RBM1"，u32 块数；每块 u16 键、u8 类型、u32 元素数，
+    // 随后为 u16 数组 / 1024 个 u64 / (u16 起点, u16 长度-1) 对
+    vector<unsigned char> serialize() const {
+        vector<unsigned char> out = { 'R', 'B', 'M', '1' };
+        putU32(out, keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            const RoaringContainer& c = containers[i];
+            putU16(out, keys[i]);
+            out.push_back((unsigned char)c.type);
+            if (c.type == RoaringContainer::ARRAY) {
+                putU32(out, c.arr.size());
+                for (unsigned short x : c.arr) putU16(out, x);
+            }
+            else if (c.type == RoaringContainer::BITSET) {
+                putU32(out, RoaringContainer::WORDS);
+                for (unsigned long long w : c.bits) {
+                    putU32(out, (unsigned int)w);
+                    putU32(out, (unsigned int)(w >> 32));
+                }
+            }
+            else {
+                putU32(out, c.runs.size() / 2);
+                for (unsigned short x : c.runs) putU16(out, x);
+            }
+        }
+        return out;
+    }
+
+    // 解析失败时清空并返回 false
+    bool deserialize(const vector<unsigned char>& in) {
+        keys.clear();
+        containers.clear();
+        _sz = 0;
+        const unsigned char* p = in.data();
+        const unsigned char* end = p + in.size();
+        if (in.size() < 8 || memcmp(p, "RBM1", 4) != 0) return false;
+        unsigned int n = getU32(p + 4);
+        p += 8;
+        // 逐个容器解码并校验：键严格递增；数组容器至多 ARRAY_MAX 个且严格递增；
+        // 游程不越过 65535 且互不重叠、按起点递增；容器非空。任何一项不满足即视为损坏
+        for (unsigned int i = 0; i < n; i++) {
+            if (end - p < 7) break;
+            RoaringContainer c;
+            unsigned short key = getU16(p);
+            if (!keys.empty() && key <= keys.back()) break;
+            int type = p[2];
+            unsigned int cnt = getU32(p + 3);
+            p += 7;
+            size_t need = type == RoaringContainer::ARRAY ? 2 * (size_t)cnt
+                : type == RoaringContainer::BITSET ? 8 * (size_t)RoaringContainer::WORDS : 4 * (size_t)cnt;
+            if (type > RoaringContainer::RUN || (size_t)(end - p) < need) break;
+            if (type == RoaringContainer::ARRAY && (cnt == 0 || cnt > RoaringContainer::ARRAY_MAX)) break;
+            if (type == RoaringContainer::RUN && (cnt == 0 || cnt > 32768)) break;
+            c.type = (RoaringContainer::Type)type;
+            bool valid = true;
+            if (type == RoaringContainer::ARRAY) {
+                for (unsigned int k = 0; k < cnt && valid; k++) {
+                    unsigned short x = getU16(p + 2 * k);
+                    if (k > 0 && x <= c.arr.back()) valid = false;
+                    c.arr.push_back(x);
+                }
+                c.card = cnt;
+            }
+            else if (type == RoaringContainer::BITSET) {
+                c.bits.resize(RoaringContainer::WORDS);
+                for (int k = 0; k < RoaringContainer::WORDS; k++) {
+                    c.bits[k] = getU32(p + 8 * k) | ((unsigned long long)getU32(p + 8 * k + 4) << 32);
+                    c.card += popcount64(c.bits[k]);
+                }
+            }
+            else {
+                int prevEnd = -1;  // 上一游程的末位
+                for (unsigned int k = 0; k < cnt && valid; k++) {
+                    int start = getU16(p + 4 * k), len = getU16(p + 4 * k + 2);
+                    if (start <= prevEnd || start + len > 65535) valid = false;
+                    prevEnd = start + len;
+                    c.runs.push_back((unsigned short)start);
+                    c.runs.push_back((unsigned short)len);
+                    c.card += len + 1;
+                }
+            }
+            if (!valid || c.card == 0) break;
+            p += need;
+            keys.push_back(key);
+            containers.push_back(c);
+            _sz += c.card;
+        }
+        if (keys.size() != n) {
+            keys.clear();
+            containers.clear();
+            _sz = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void dump(char* file) const {
+        FILE* fp = fopen(file, "wb");
+        if (fp) {
+            vector<unsigned char> bytes = serialize();
+            fwrite(bytes.data(), 1, bytes.size(), fp);
+            fclose(fp);
+        }
+    }
+};
+
+
+// ====================== 并发位图：定长、原子读写，可多线程 set/test ======================
+// 容量在构造时固定，不会扩容，读写可与其他线程并发进行
+class ConcurrentBitmap {
+private:
+    static const int SLOTS = 64;   // 计数槽数，线程按编号轮流分到各槽
+
+    // 每槽按 64 字节对齐并独占一条缓存行，避免不同线程的计数落在同一缓存行。
+    // 对象因此要求 64 字节对齐，应放在栈上或作为成员；C++17 之前 new 不保证这种对齐
+    struct alignas(64) PaddedCounter {
+        atomic<long long> v;
+    };
+
+    atomic<unsigned long long>* M;
+    Rank N;                         // 字数
+    PaddedCounter counters[SLOTS];
+
+    // 当前线程的计数槽，首次调用时分配
+    static int mySlot() {
+        static atomic<int> nextSlot(0);
+        thread_local int slot = nextSlot.fetch_add(1) % SLOTS;
+        return slot;
+    }
+
+public:
+    ConcurrentBitmap(Rank n) : N((Rank)(((long long)n + 63) / 64)) {
+        M = new atomic<unsigned long long>[N];
+        for (Rank i = 0; i < N; i++) M[i].store(0, memory_order_relaxed);
+        for (int i = 0; i < SLOTS; i++) counters[i].v.store(0, memory_order_relaxed);
+    }
+
+    ~ConcurrentBitmap() {
+        delete[] M;
+        M = NULL;
+        N = 0;
+    }
+
+    ConcurrentBitmap(const ConcurrentBitmap&) = delete;
+    ConcurrentBitmap& operator=(const ConcurrentBitmap&) = delete;
+
+    long long capacity() const { return (long long)N * 64; }
+
+    // 各槽计数之和；并发修改期间为近似值，所有写线程结束后精确
+    Rank size() const {
+        long long s = 0;
+        for (int i = 0; i < SLOTS; i++) s += counters[i].v.load(memory_order_relaxed);
+        return (Rank)s;
+    }
+
+    // 原子置位并返回原值：fetch_or 保证多个线程同时置同一位时只有一个得到 false
+    bool testAndSet(Rank k) {
+        if (k < 0 || k >= capacity()) return false;
+        unsigned long long mask = 1ULL << (k & 63);
+        unsigned long long old = M[k >> 6].fetch_or(mask, memory_order_acq_rel);
+        if (old & mask) return true;
+        counters[mySlot()].v.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+
+    // 越界编号忽略
+    void set(Rank k) { testAndSet(k); }
+
+    void clear(Rank k) {
+        if (k < 0 || k >= capacity()) return;
+        unsigned long long mask = 1ULL << (k & 63);
+        unsigned long long old = M[k >> 6].fetch_and(~mask, memory_order_acq_rel);
+        if (old & mask) counters[mySlot()].v.fetch_sub(1, memory_order_relaxed);
+    }
+
+    bool test(Rank k) const {
+        if (k < 0 || k >= capacity()) return false;
+        return (M[k >> 6].load(memory_order_acquire) >> (k & 63)) & 1;
+    }
+
+    // 多线程分段清零全部位；调用期间不应有其他线程写入
+    void clearAll(int threads = 0) {
+        if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+        vector<thread> workers;
+        Rank per = (N + threads - 1) / threads;
+        for (int t = 0; t < threads; t++) {
+            Rank lo = min(N, t * per), hi = min(N, lo + per);
+            workers.emplace_back([this, lo, hi]() {
+                for (Rank i = lo; i < hi; i++) M[i].store(0, memory_order_relaxed);
+            });
+        }
+        for (auto& w : workers) w.join();
+        for (int i = 0; i < SLOTS; i++) counters[i].v.store(0, memory_order_relaxed);
+    }
+};
+
+
+// ====================== 文件映射位图：mmap 持久化，按页读写 ======================
+// 文件内容即位图本身（格式同 Bitmap::dump），打开只建立映射，不读入数据；
+// 修改直接落在映射页上，flush() 把脏页同步回磁盘
+class MappedBitmap {
+private:
+    unsigned char* M;   // 映射起始地址
+    size_t N;           // 映射字节数（即文件长度）
+    Rank _sz;           // 置位位数，-1 表示尚未统计
+#ifdef _WIN32
+    HANDLE hFile;
+    HANDLE hMap;
+#else
+    int fd;
+#endif
+
+    // 将文件扩到至少 bytes 字节并建立（或重建）映射；
+    // 失败时原映射和 N 保持不变，已置的位不会丢
+    bool mapFile(size_t bytes) {
+#ifdef _WIN32
+        // 先建新映射再释放旧映射；映射长度超过文件长度时系统会自动扩展文件
+        HANDLE h = CreateFileMappingA(hFile, NULL, PAGE_READWRITE,
+            (DWORD)((unsigned long long)bytes >> 32), (DWORD)bytes, NULL);
+        if (!h) return false;
+        unsigned char* p = (unsigned char*)MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+        if (!p) {
+            CloseHandle(h);
+            return false;
+        }
+        if (M) UnmapViewOfFile(M);
+        if (hMap) CloseHandle(hMap);
+        hMap = h;
+        M = p;
+#else
+        if (ftruncate(fd, (off_t)bytes) != 0) return false;
+        void* p;
+#ifdef __linux__
+        // mremap 失败时原映射仍然有效
+        p = M ? mremap(M, N, bytes, MREMAP_MAYMOVE) : mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+#else
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED && M) munmap(M, N);
+#endif
+        if (p == MAP_FAILED) {
+            if (M) {   // 文件长度退回原映射大小
+                int rc = ftruncate(fd, (off_t)N);
+                (void)rc;
+            }
+            return false;
+        }
+        M = (unsigned char*)p;
+#endif
+        N = bytes;
+        return true;
+    }
+
+    // 保证第 k 位已映射；扩容失败返回 false
+    bool expand(Rank k) {
+        if ((size_t)k < 8 * N) return true;
+        return mapFile((2 * (size_t)k + 7) / 8);
+    }
+
+public:
+    // 打开或创建文件，长度不足 n 位时补零扩展
+    MappedBitmap(const char* file, Rank n = 8) : M(NULL), N(0), _sz(-1) {
+#ifdef _WIN32
+        hMap = NULL;
+        hFile = CreateFileA(file, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER len;
+        GetFileSizeEx(hFile, &len);
+        size_t fileBytes = (size_t)len.QuadPart;
+#else
+        fd = open(file, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return;
+        struct stat st;
+        fstat(fd, &st);
+        size_t fileBytes = (size_t)st.st_size;
+#endif
+        mapFile(max(fileBytes, max((size_t)1, ((size_t)max(n, (Rank)0) + 7) / 8)));
+    }
+
+    // 解除映射；MAP_SHARED 的修改此后仍由系统写回，需要落盘保证时先调用 flush()
+    ~MappedBitmap() {
+#ifdef _WIN32
+        if (M) UnmapViewOfFile(M);
+        if (hMap) CloseHandle(hMap);
+        if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+#else
+        if (M) munmap(M, N);
+        if (fd >= 0) close(fd);
+#endif
+        M = NULL;
+        N = 0;
+    }
+
+    MappedBitmap(const MappedBitmap&) = delete;
+    MappedBitmap& operator=(const MappedBitmap&) = delete;
+
+    bool isOpen() const { return M != NULL; }
+
+    // 首次调用时统计一次，之后随 set/clear 维护
+    Rank size() {
+        if (_sz < 0) {
+            _sz = 0;
+            size_t i = 0;
+            for (; i + 8 <= N; i += 8) {
+                unsigned long long w;
+                memcpy(&w, M + i, 8);
+                _sz += popcount64(w);
+            }
+            for (; i < N; i++) _sz += popcount64(M[i]);
+        }
+        return _sz;
+    }
+
+    // 文件无法扩展（磁盘满、地址空间不足等）时返回 false，位图内容不变
+    bool set(Rank k) {
+        if (!M || k < 0 || !expand(k)) return false;
+        if (test(k)) return true;
+        M[k >> 3] |= (0x80 >> (k & 0x07));
+        if (_sz >= 0) _sz++;
+        return true;
+    }
+
+    void clear(Rank k) {
+        if (!test(k)) return;
+        M[k >> 3] &= ~(0x80 >> (k & 0x07));
+        if (_sz >= 0) _sz--;
+    }
+
+    bool test(Rank k) const {
+        if (!M || k < 0 || (size_t)k >= 8 * N) return false;
+        return M[k >> 3] & (0x80 >> (k & 0x07));
+    }
+
+    // 将脏页同步写回文件，只有被修改过的页会产生磁盘写
+    bool flush() {
+        if (!M) return false;
+#ifdef _WIN32
+        return FlushViewOfFile(M, 0) && FlushFileBuffers(hFile);
+#else
+        return msync(M, N, MS_SYNC) == 0;
+#endif
+    }
+
+    // 另存一份，格式同 Bitmap::dump
+    void dump(char* file) {
+        FILE* fp = fopen(file, "wb");
+        if (fp) {
+            if (M) fwrite(M, sizeof(char), N, fp);
+            fclose(fp);
+        }
+    }
+};
+
+
 template <typename T>
 struct BinNode {
     T data;              
     BinNode<T>* left;     
     BinNode<T>* right;   
+    BinNode<T>* parent;
 
 
-    BinNode(T val = T()) : data(val), left(nullptr), right(nullptr) {}
+    BinNode(T val = T()) : data(val), left(nullptr), right(nullptr), parent(nullptr) {}
 };
 
 
@@ -161,6 +1060,14 @@ struct HuffData {
 };
 
 
+// 优先队列比较器：权重小的子树优先出队
+struct HuffNodeCmp {
+    bool operator()(BinNode<HuffData>* a, BinNode<HuffData>* b) const {
+        return a->data.weight > b->data.weight;
+    }
+};
+
+
 class HuffTree : public BinTree<HuffData> {
 private:
 
@@ -184,26 +1091,32 @@ private:
 public:
 
     void buildTree(map<char, int>& freqMap) {
-        
-        priority_queue<HuffData> pq;
+        clear(this->_root);
+        this->_root = nullptr;
+
+        // 队列中存放子树根节点，按权重取最小的两棵合并
+        priority_queue<BinNode<HuffData>*, vector<BinNode<HuffData>*>, HuffNodeCmp> pq;
         for (auto& pair : freqMap) {
-            pq.push(HuffData(pair.first, pair.second));
+            pq.push(new BinNode<HuffData>(HuffData(pair.first, pair.second)));
+            this->_size++;
         }
 
         
         while (pq.size() > 1) {
-            HuffData leftData = pq.top(); pq.pop();
-            HuffData rightData = pq.top(); pq.pop();
+            BinNode<HuffData>* leftNode = pq.top(); pq.pop();
+            BinNode<HuffData>* rightNode = pq.top(); pq.pop();
 
-            HuffData parentData('\0', leftData.weight + rightData.weight);
+            HuffData parentData('\0', leftNode->data.weight + rightNode->data.weight);
             BinNode<HuffData>* parent = new BinNode<HuffData>(parentData);
-            parent->left = new BinNode<HuffData>(leftData);
-            parent->right = new BinNode<HuffData>(rightData);
-
-            pq.push(parentData);
+            parent->left = leftNode;
+            parent->right = rightNode;
+            leftNode->parent = parent;
+            rightNode->parent = parent;
 
-            this->setRoot(parent);
+            pq.push(parent);
+            this->_size++;
         }
+        if (!pq.empty()) this->_root = pq.top();
     }
 
     
@@ -264,6 +1177,532 @@ string decodeString(const string& code, HuffTree& tree) {
     return res;
 }
 
+// ====================== 7. 查表解码与四路交错流编解码 ======================
+// 定长码表：由 getHuffCode() 得到的 map<char, string> 转换而来
+struct HuffCodeTable {
+    static const int MAX_BITS = 20;  // 查找表最多 2^20 项，更长的码长不支持
+
+    unsigned int code[256];          // 码字（右对齐）
+    unsigned char len[256];          // 码长，0 表示该字符无编码
+    int maxLen;                      // 最长码长，即查找表下标位数
+    vector<unsigned char> decSym;    // 查找表：以 maxLen 位前缀为下标得到字符
+    vector<unsigned char> decLen;    // 查找表：对应字符的码长
+
+    HuffCodeTable() : maxLen(0) {
+        memset(code, 0, sizeof(code));
+        memset(len, 0, sizeof(len));
+    }
+
+    // 由编码表构造码表与查找表，码长超出 MAX_BITS 或编码表为空时返回 false
+    bool build(const map<char, string>& codeMap) {
+        memset(code, 0, sizeof(code));
+        memset(len, 0, sizeof(len));
+        maxLen = 0;
+        for (auto& pair : codeMap) {
+            int l = pair.second.size();
+            if (l == 0) continue;
+            if (l > MAX_BITS) return false;
+            unsigned char s = (unsigned char)pair.first;
+            unsigned int c = 0;
+            for (char b : pair.second) c = (c << 1) | (b == '1' ? 1 : 0);
+            code[s] = c;
+            len[s] = (unsigned char)l;
+            if (l > maxLen) maxLen = l;
+        }
+        if (maxLen == 0) return false;
+
+        // 码字 c 填满以它为前缀的所有表项
+        decSym.assign(1u << maxLen, 0);
+        decLen.assign(1u << maxLen, 0);
+        for (int s = 0; s < 256; s++) {
+            if (!len[s]) continue;
+            int shift = maxLen - len[s];
+            unsigned int first = code[s] << shift;
+            for (unsigned int k = 0; k < (1u << shift); k++) {
+                decSym[first + k] = (unsigned char)s;
+                decLen[first + k] = len[s];
+            }
+        }
+        return true;
+    }
+};
+
+// 位写入器：与 Bitmap 一致按高位在前写入字节流
+struct HuffBitWriter {
+    vector<unsigned char>& out;
+    unsigned long long buf;
+    int cnt;                         // buf 中尚未写出的位数
+
+    HuffBitWriter(vector<unsigned char>& o) : out(o), buf(0), cnt(0) {}
+
+    void put(unsigned int c, int l) {
+        buf = (buf << l) | c;
+        cnt += l;
+        while (cnt >= 8) {
+            cnt -= 8;
+            out.push_back((unsigned char)(buf >> cnt));
+        }
+    }
+
+    // 末尾不足一字节时低位补 0
+    void flush() {
+        if (cnt > 0) out.push_back((unsigned char)(buf << (8 - cnt)));
+        cnt = 0;
+    }
+};
+
+// 位读取器：64 位缓冲左对齐，越过流末尾时补 0（解码由符号数控制结束）
+struct HuffBitReader {
+    const unsigned char* p;
+    const unsigned char* end;
+    unsigned long long buf;
+    int cnt;                         // buf 中有效位数
+
+    void init(const vector<unsigned char>& s) {
+        p = s.data();
+        end = p + s.size();
+        buf = 0;
+        cnt = 0;
+        refill();
+    }
+
+    void refill() {
+        while (cnt <= 56) {
+            unsigned long long b = p < end ? *p++ : 0;
+            buf |= b << (56 - cnt);
+            cnt += 8;
+        }
+    }
+
+    // 取 maxLen 位前缀查表，只消耗实际码长
+    unsigned char decode(const HuffCodeTable& t) {
+        refill();
+        unsigned int idx = (unsigned int)(buf >> (64 - t.maxLen));
+        int l = t.decLen[idx];
+        buf <<= l;
+        cnt -= l;
+        return t.decSym[idx];
+    }
+};
+
+// 编码块：块内符号均分为四段，各段独立成流（同 Huff0 的四流格式）
+struct HuffBlock4 {
+    int count;                       // 本块符号数
+    vector<unsigned char> stream[4]; // 四段子流
+};
+
+// 第 k 段的起点与长度：前三段长度为 ceil(count/4)，第四段取余下部分
+static inline void huffSegment(int count, int k, int& start, int& segLen) {
+    int seg = (count + 3) / 4;
+    start = min(count, k * seg);
+    segLen = min(seg, count - start);
+}
+
+// 四流编码（大小写与无编码字符的处理同 encodeString）
+vector<HuffBlock4> encodeStreams4(const string& str, const HuffCodeTable& table, int blockSize = 65536) {
+    string syms;
+    syms.reserve(str.size());
+    for (char ch : str) {
+        if (ch >= 'A' && ch <= 'Z') ch = tolower(ch);
+        if (table.len[(unsigned char)ch]) syms += ch;
+    }
+
+    vector<HuffBlock4> blocks;
+    for (int base = 0; base < (int)syms.size(); base += blockSize) {
+        HuffBlock4 blk;
+        blk.count = min(blockSize, (int)syms.size() - base);
+        for (int k = 0; k < 4; k++) {
+            int start, segLen;
+            huffSegment(blk.count, k, start, segLen);
+            HuffBitWriter w(blk.stream[k]);
+            for (int i = 0; i < segLen; i++) {
+                unsigned char s = (unsigned char)syms[base + start + i];
+                w.put(table.code[s], table.len[s]);
+            }
+            w.flush();
+        }
+        blocks.push_back(blk);
+    }
+    return blocks;
+}
+
+// 四流解码：一次循环推进四个游标，四条码长依赖链互不相关，可并行执行
+string decodeStreams4(const vector<HuffBlock4>& blocks, const HuffCodeTable& table) {
+    size_t total = 0;
+    for (auto& blk : blocks) total += blk.count;
+    string res(total, '\0');
+
+    size_t base = 0;
+    for (auto& blk : blocks) {
+        HuffBitReader r[4];
+        char* out[4];
+        int segLen[4];
+        for (int k = 0; k < 4; k++) {
+            int start;
+            huffSegment(blk.count, k, start, segLen[k]);
+            r[k].init(blk.stream[k]);
+            out[k] = &res[0] + base + start;
+        }
+
+        // 第四段最短，四路交错解码到它的长度
+        int common = segLen[3];
+        for (int i = 0; i < common; i++) {
+            out[0][i] = r[0].decode(table);
+            out[1][i] = r[1].decode(table);
+            out[2][i] = r[2].decode(table);
+            out[3][i] = r[3].decode(table);
+        }
+        // 前三段剩余的尾部
+        for (int k = 0; k < 3; k++) {
+            for (int i = common; i < segLen[k]; i++) {
+                out[k][i] = r[k].decode(table);
+            }
+        }
+        base += blk.count;
+    }
+    return res;
+}
+
+// ====================== 8. 自适应哈夫曼编码（FGK）与周期重建半自适应编码 ======================
+// 自适应哈夫曼树节点数据
+struct AdaptiveHuffData {
+    static const int NYT = -1;       // 未出现字符的转义节点
+    static const int INTERNAL = -2;  // 内部节点
+
+    int sym;      // 叶节点字符（0~255）
+    int weight;
+    int order;    // 节点编号，根为 0；兄弟性质要求 weight 随编号增大不增
+
+    AdaptiveHuffData(int s = NYT, int w = 0, int o = 0) : sym(s), weight(w), order(o) {}
+};
+
+// FGK 自适应哈夫曼树：每处理一个字符即增量更新，编码端与解码端各维护一棵
+class AdaptiveHuffTree : public BinTree<AdaptiveHuffData> {
+private:
+    vector<BinNode<AdaptiveHuffData>*> nodes;  // 按编号排列的全部节点
+    BinNode<AdaptiveHuffData>* leaf[256];      // 字符对应的叶节点
+    BinNode<AdaptiveHuffData>* nyt;
+
+    // 交换两棵子树在树中的位置及编号（二者互不为祖先）
+    void swapNodes(BinNode<AdaptiveHuffData>* a, BinNode<AdaptiveHuffData>* b) {
+        BinNode<AdaptiveHuffData>* pa = a->parent;
+        BinNode<AdaptiveHuffData>* pb = b->parent;
+        bool aLeft = pa->left == a;
+        bool bLeft = pb->left == b;
+        if (aLeft) pa->left = b; else pa->right = b;
+        if (bLeft) pb->left = a; else pb->right = a;
+        a->parent = pb;
+        b->parent = pa;
+        swap(nodes[a->data.order], nodes[b->data.order]);
+        swap(a->data.order, b->data.order);
+    }
+
+public:
+    AdaptiveHuffTree() { reset(); }
+
+    // 回到只有 NYT 节点的初始状态
+    void reset() {
+        clear(this->_root);
+        nyt = new BinNode<AdaptiveHuffData>(AdaptiveHuffData(AdaptiveHuffData::NYT, 0, 0));
+        this->_root = nyt;
+        this->_size = 1;
+        nodes.assign(1, nyt);
+        for (int s = 0; s < 256; s++) leaf[s] = nullptr;
+    }
+
+    BinNode<AdaptiveHuffData>* leafOf(int sym) { return leaf[sym]; }
+    BinNode<AdaptiveHuffData>* nytNode() { return nyt; }
+
+    // 字符 sym 的权重加一：新字符先由 NYT 分裂出叶节点，
+    // 再自叶向根逐层与所在权重块的首节点交换后加一
+    void update(int sym) {
+        BinNode<AdaptiveHuffData>* q = leaf[sym];
+        if (!q) {
+            int n = nodes.size();
+            BinNode<AdaptiveHuffData>* lf = new BinNode<AdaptiveHuffData>(AdaptiveHuffData(sym, 0, n));
+            BinNode<AdaptiveHuffData>* newNyt = new BinNode<AdaptiveHuffData>(AdaptiveHuffData(AdaptiveHuffData::NYT, 0, n + 1));
+            nyt->data.sym = AdaptiveHuffData::INTERNAL;
+            nyt->left = newNyt;
+            nyt->right = lf;
+            newNyt->parent = nyt;
+            lf->parent = nyt;
+            nodes.push_back(lf);
+            nodes.push_back(newNyt);
+            this->_size += 2;
+            nyt = newNyt;
+            leaf[sym] = lf;
+            q = lf;
+        }
+        while (q) {
+            int j = q->data.order;
+            while (j > 0 && nodes[j - 1]->data.weight == q->data.weight) j--;
+            BinNode<AdaptiveHuffData>* leader = nodes[j];
+            if (leader != q && leader != q->parent) swapNodes(q, leader);
+            q->data.weight++;
+            q = q->parent;
+        }
+    }
+};
+
+// 自适应编码器：单遍处理，无需预先统计频率。
+// 新字符输出 NYT 路径 + 9 位原始值；原始值 256 为冲刷标记，其后补齐到字节边界
+class AdaptiveHuffEncoder {
+private:
+    static const int FLUSH_MARK = 256;
+
+    AdaptiveHuffTree tree;
+    vector<unsigned char> pending;
+    HuffBitWriter writer;
+
+    // 输出节点自根到自身的路径，左 0 右 1
+    void emitPath(BinNode<AdaptiveHuffData>* node) {
+        int bits[520];
+        int n = 0;
+        for (; node->parent; node = node->parent) {
+            bits[n++] = node->parent->right == node ? 1 : 0;
+        }
+        while (n > 0) writer.put(bits[--n], 1);
+    }
+
+    void takeBytes(vector<unsigned char>& out) {
+        out.insert(out.end(), pending.begin(), pending.end());
+        pending.clear();
+    }
+
+public:
+    AdaptiveHuffEncoder() : writer(pending) {}
+
+    // 编码一段数据，已凑满的字节追加到 out
+    void encode(const char* data, int n, vector<unsigned char>& out) {
+        for (int i = 0; i < n; i++) {
+            int sym = (unsigned char)data[i];
+            BinNode<AdaptiveHuffData>* q = tree.leafOf(sym);
+            if (q) {
+                emitPath(q);
+            }
+            else {
+                emitPath(tree.nytNode());
+                writer.put(sym, 9);
+            }
+            tree.update(sym);
+        }
+        takeBytes(out);
+    }
+
+    // 写出冲刷标记并补齐字节，使已编码数据可被对端立即完整解码
+    void flush(vector<unsigned char>& out) {
+        emitPath(tree.nytNode());
+        writer.put(FLUSH_MARK, 9);
+        writer.flush();
+        takeBytes(out);
+    }
+};
+
+// 自适应解码器：逐位推进的状态机，可接收任意切分的字节流
+class AdaptiveHuffDecoder {
+private:
+    AdaptiveHuffTree tree;
+    BinNode<AdaptiveHuffData>* cur;  // 当前走到的节点
+    int rawBits;                     // 正在读取的原始值已读位数，-1 表示在走树
+    int rawVal;
+
+    // 回到根；根为叶时只可能是初始的 NYT，直接读原始值
+    void restart() {
+        cur = tree.root();
+        rawBits = cur->left ? -1 : 0;
+        rawVal = 0;
+    }
+
+public:
+    AdaptiveHuffDecoder() { restart(); }
+
+    void decode(const unsigned char* data, int n, string& out) {
+        for (int i = 0; i < n; i++) {
+            for (int b = 7; b >= 0; b--) {
+                int bit = (data[i] >> b) & 1;
+                if (rawBits < 0) {
+                    cur = bit ? cur->right : cur->left;
+                    if (cur->left) continue;
+                    if (cur->data.sym >= 0) {
+                        out += (char)cur->data.sym;
+                        tree.update(cur->data.sym);
+                        restart();
+                    }
+                    else {
+                        rawBits = 0;
+                        rawVal = 0;
+                    }
+                    continue;
+                }
+                rawVal = (rawVal << 1) | bit;
+                if (++rawBits < 9) continue;
+                if (rawVal == 256) {  // 冲刷标记：丢弃本字节剩余的填充位
+                    restart();
+                    break;
+                }
+                out += (char)rawVal;
+                tree.update(rawVal);
+                restart();
+            }
+        }
+    }
+};
+
+// 半自适应编码的码树重建：累计频率按比例压缩到总权重不超过 8192，
+// 保证码长不超过 HuffCodeTable::MAX_BITS；每个字节至少权重 1，始终可编码
+static void rebuildSemiTree(long long freq[256], HuffTree& tree, HuffCodeTable* table) {
+    const long long LIMIT = 8192 - 256;
+    long long total = 0;
+    for (int s = 0; s < 256; s++) total += freq[s];
+
+    map<char, int> freqMap;
+    for (int s = 0; s < 256; s++) {
+        long long w = total > LIMIT ? freq[s] * LIMIT / total : freq[s];
+        freqMap[(char)s] = 1 + (int)w;
+    }
+    tree.buildTree(freqMap);
+    if (table) table->build(tree.getHuffCode());
+
+    // 频率减半，使后续码树更偏向最近的数据
+    for (int s = 0; s < 256; s++) freq[s] /= 2;
+}
+
+// 周期重建的半自适应编码器：每编码 rebuildBytes 个字节按累计频率重建一次码树，
+// 两次重建之间按静态码表查表编码，将建树代价摊到 rebuildBytes 个字节上。
+// 每次 encode 输出一帧：32 位字节数 + 码流，末尾补齐到字节边界
+class SemiAdaptiveHuffEncoder {
+private:
+    int rebuildBytes;
+    int sinceRebuild;
+    long long freq[256];
+    HuffTree tree;
+    HuffCodeTable table;
+    vector<unsigned char> pending;
+    HuffBitWriter writer;
+
+public:
+    SemiAdaptiveHuffEncoder(int rebuildKB = 4) : rebuildBytes(rebuildKB * 1024), sinceRebuild(0), writer(pending) {
+        memset(freq, 0, sizeof(freq));
+        rebuildSemiTree(freq, tree, &table);
+    }
+
+    void encode(const char* data, int n, vector<unsigned char>& out) {
+        writer.put((unsigned int)n, 32);
+        for (int i = 0; i < n; i++) {
+            unsigned char s = (unsigned char)data[i];
+            writer.put(table.code[s], table.len[s]);
+            freq[s]++;
+            if (++sinceRebuild == rebuildBytes) {
+                rebuildSemiTree(freq, tree, &table);
+                sinceRebuild = 0;
+            }
+        }
+        writer.flush();
+        out.insert(out.end(), pending.begin(), pending.end());
+        pending.clear();
+    }
+
+    // 每帧已补齐到字节边界，无需额外冲刷
+    void flush(vector<unsigned char>&) {}
+};
+
+// 半自适应解码器：按帧头计数沿码树逐位解码，在与编码端相同的位置重建码树
+class SemiAdaptiveHuffDecoder {
+private:
+    int rebuildBytes;
+    int sinceRebuild;
+    long long freq[256];
+    HuffTree tree;
+    BinNode<HuffData>* cur;
+    int headerBits;                  // 已读帧头位数，32 表示帧头读完
+    unsigned int remaining;          // 本帧剩余字节数
+
+public:
+    SemiAdaptiveHuffDecoder(int rebuildKB = 4) : rebuildBytes(rebuildKB * 1024), sinceRebuild(0), headerBits(0), remaining(0) {
+        memset(freq, 0, sizeof(freq));
+        rebuildSemiTree(freq, tree, nullptr);
+        cur = tree.root();
+    }
+
+    void decode(const unsigned char* data, int n, string& out) {
+        for (int i = 0; i < n; i++) {
+            for (int b = 7; b >= 0; b--) {
+                int bit = (data[i] >> b) & 1;
+                if (headerBits < 32) {
+                    remaining = (remaining << 1) | bit;
+                    if (++headerBits == 32 && remaining == 0) headerBits = 0;
+                    continue;
+                }
+                cur = bit ? cur->right : cur->left;
+                if (cur->left || cur->right) continue;
+
+                unsigned char s = (unsigned char)cur->data.ch;
+                out += (char)s;
+                freq[s]++;
+                if (++sinceRebuild == rebuildBytes) {
+                    rebuildSemiTree(freq, tree, nullptr);
+                    sinceRebuild = 0;
+                }
+                cur = tree.root();
+                if (--remaining == 0) {  // 帧结束：丢弃本字节剩余的填充位
+                    headerBits = 0;
+                    break;
+                }
+            }
+        }
+    }
+};
+
+// 本地字节管道：模拟 socket，读端每次最多取 maxBytes，不保留写端的分块边界
+struct LocalPipe {
+    string buf;
+    size_t readPos;
+
+    LocalPipe() : readPos(0) {}
+
+    void write(const vector<unsigned char>& bytes) {
+        buf.append(bytes.begin(), bytes.end());
+    }
+
+    int read(unsigned char* dst, int maxBytes) {
+        int n = (int)min((size_t)maxBytes, buf.size() - readPos);
+        memcpy(dst, buf.data() + readPos, n);
+        readPos += n;
+        return n;
+    }
+};
+
+// 流式传输测试：发送端按 chunk 字节分块编码写入管道，接收端每次读 100 字节解码
+template <typename Encoder, typename Decoder>
+void testStreamCoder(const string& name, Encoder& enc, Decoder& dec, const string& text, int chunk, bool flushEachChunk) {
+    LocalPipe pipe;
+    string received;
+    vector<unsigned char> bytes;
+    unsigned char rbuf[100];
+    size_t sent = 0;
+
+    auto t0 = chrono::high_resolution_clock::now();
+    for (size_t pos = 0; pos < text.size(); pos += chunk) {
+        int n = (int)min((size_t)chunk, text.size() - pos);
+        bytes.clear();
+        enc.encode(text.data() + pos, n, bytes);
+        if (flushEachChunk) enc.flush(bytes);
+        pipe.write(bytes);
+        sent += bytes.size();
+
+        int got;
+        while ((got = pipe.read(rbuf, sizeof(rbuf))) > 0) {
+            dec.decode(rbuf, got, received);
+        }
+    }
+    auto t1 = chrono::high_resolution_clock::now();
+
+    cout << "  " << name << ": " << text.size() << " -> " << sent << " 字节（"
+        << 100.0 * sent / text.size() << "%）, 耗时 "
+        << chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / 1000.0 << "ms"
+        << ", 还原一致: " << (received == text ? "是" : "否") << endl;
+}
+
 // ====================== 主函数：测试实验功能 ======================
 int main() {
     // 1. 完整《I have a dream》原文
@@ -339,6 +1778,200 @@ int main() {
         cout << "  解码: " << decode << endl;
     }
 
+    // 6. 四路交错流查表解码 vs decodeString 树遍历解码
+    HuffCodeTable table;
+    if (table.build(codeMap)) {
+        string bigText;
+        for (int r = 0; r < 200; r++) bigText += speech;
+        string bitStr = encodeString(bigText, codeMap);
+        vector<HuffBlock4> blocks = encodeStreams4(bigText, table);
+
+        auto t0 = chrono::high_resolution_clock::now();
+        string treeRes = decodeString(bitStr, huffTree);
+        auto t1 = chrono::high_resolution_clock::now();
+        string streamRes = decodeStreams4(blocks, table);
+        auto t2 = chrono::high_resolution_clock::now();
+
+        size_t bytes4 = 0;
+        for (auto& blk : blocks) {
+            for (int k = 0; k < 4; k++) bytes4 += blk.stream[k].size();
+        }
+        double treeTime = chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / 1000.0;
+        double streamTime = chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+        cout << "\n=== 解码性能对比（" << treeRes.size() << " 个字符）===" << endl;
+        cout << "  树遍历 decodeString: " << treeTime << "ms" << endl;
+        cout << "  四路交错流查表解码: " << streamTime << "ms（" << blocks.size()
+            << " 块, " << bytes4 << " 字节）" << endl;
+        cout << "  结果一致: " << (treeRes == streamRes ? "是" : "否") << endl;
+    }
+
+    // 7. 单遍流式编码：经本地管道按 512 字节分块传输
+    cout << "\n=== 单遍流式编码（512 字节分块）===" << endl;
+    string streamText;
+    for (int r = 0; r < 20; r++) streamText += speech;
+    {
+        AdaptiveHuffEncoder enc;
+        AdaptiveHuffDecoder dec;
+        testStreamCoder("FGK 自适应", enc, dec, streamText, 512, true);
+    }
+    {
+        SemiAdaptiveHuffEncoder enc(4);
+        SemiAdaptiveHuffDecoder dec(4);
+        testStreamCoder("半自适应(每 4KB 重建)", enc, dec, streamText, 512, false);
+    }
+
+    // 8. 字级位图：与逐位 Bitmap 对比，并校验 rank/select 与批量运算
+    cout << "\n=== 字级位图 WordBitmap ===" << endl;
+    {
+        const Rank universe = 1 << 24;
+        const int ops = 2000000;
+        vector<Rank> ids(ops);
+        unsigned int seed = 12345;
+        for (int i = 0; i < ops; i++) {
+            seed = seed * 1103515245u + 12345u;
+            ids[i] = (Rank)((seed >> 4) % universe);
+        }
+
+        Bitmap byteMap(universe);
+        WordBitmap wordMap(universe);
+        auto t0 = chrono::high_resolution_clock::now();
+        for (Rank k : ids) byteMap.set(k);
+        Rank hitsByte = 0;
+        for (Rank k : ids) hitsByte += byteMap.test(k + 1) ? 1 : 0;
+        auto t1 = chrono::high_resolution_clock::now();
+        for (Rank k : ids) wordMap.set(k);
+        Rank hitsWord = 0;
+        for (Rank k : ids) hitsWord += wordMap.test(k + 1) ? 1 : 0;
+        auto t2 = chrono::high_resolution_clock::now();
+        cout << "  Bitmap set+test: " << chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / 1000.0 << "ms"
+            << ", WordBitmap set+test: " << chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0 << "ms"
+            << ", 计数一致: " << (byteMap.size() == wordMap.size() && hitsByte == hitsWord ? "是" : "否") << endl;
+
+        // rank/select 互逆性与逐位计数校验
+        bool ok = true;
+        for (Rank j = 0; j < wordMap.size(); j += 997) {
+            Rank pos = wordMap.select(j);
+            if (pos < 0 || !wordMap.test(pos) || wordMap.rank(pos) != j) ok = false;
+        }
+        Rank naive = 0;
+        for (Rank k = 0; k < 100000; k++) naive += wordMap.test(k) ? 1 : 0;
+        if (wordMap.rank(100000) != naive) ok = false;
+        cout << "  rank/select 校验: " << (ok ? "通过" : "失败") << endl;
+
+        WordBitmap evens(universe), a(universe), b(universe), c(universe);
+        for (Rank k = 0; k < universe; k += 2) evens.set(k);
+        a.orWith(wordMap);  a.andWith(evens);
+        b.orWith(wordMap);  b.andNotWith(evens);
+        c.orWith(a);        c.xorWith(b);
+        cout << "  按字运算: AND " << a.size() << " + ANDNOT " << b.size()
+            << " = XOR " << c.size() << " (总数 " << wordMap.size() << ")" << endl;
+    }
+
+    // 9. 压缩位图：2^32 全域内的稀疏编号加一段连续区间
+    cout << "\n=== 压缩位图 RoaringBitmap ===" << endl;
+    {
+        RoaringBitmap sparse, dense;
+        unsigned int seed = 2024, maxId = 0;
+        vector<unsigned int> ids;
+        for (int i = 0; i < 500000; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            ids.push_back(seed);
+            maxId = max(maxId, seed);
+            sparse.set(seed);
+        }
+        for (unsigned int k = 0; k < 3000000; k++) dense.set(k);
+        for (unsigned int k = 0; k < 3000000; k += 3) sparse.set(k);
+        dense.optimize();
+        sparse.optimize();
+        cout << "  稀疏位图: " << sparse.size() << " 个编号, 占用 " << sparse.sizeInBytes() / 1024
+            << "KB（Bitmap 需 " << (maxId / 8 + 1) / 1024 << "KB）" << endl;
+        cout << "  连续区间: " << dense.size() << " 个编号, 占用 " << dense.sizeInBytes() / 1024 << "KB" << endl;
+
+        auto t0 = chrono::high_resolution_clock::now();
+        RoaringBitmap both = RoaringBitmap::intersect(sparse, dense);
+        RoaringBitmap either = RoaringBitmap::unite(sparse, dense);
+        auto t1 = chrono::high_resolution_clock::now();
+        long long expectBoth = 0;
+        for (unsigned int k = 0; k < 3000000; k++) expectBoth += sparse.test(k) ? 1 : 0;
+        cout << "  交集 " << both.size() << "（期望 " << expectBoth << "）, 并集 " << either.size()
+            << "（期望 " << sparse.size() + dense.size() - expectBoth << "）, 耗时 "
+            << chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / 1000.0 << "ms" << endl;
+
+        bool ok = true;
+        for (unsigned int id : ids) if (!sparse.test(id)) ok = false;
+        for (int i = 0; i < 1000; i++) sparse.clear(ids[i]);
+        if (sparse.test(ids[0]) || sparse.size() != either.size() - dense.size() + expectBoth - 1000) ok = false;
+        RoaringBitmap loaded;
+        loaded.deserialize(sparse.serialize());
+        if (loaded.size() != sparse.size() || RoaringBitmap::intersect(loaded, sparse).size() != sparse.size()) ok = false;
+        cout << "  set/clear/test 与序列化往返: " << (ok ? "通过" : "失败") << endl;
+    }
+
+    // 10. 并发位图：多线程去重，每个编号只被一个线程认领
+    cout << "\n=== 并发位图 ConcurrentBitmap ===" << endl;
+    {
+        const Rank universe = 1 << 24;
+        const int threads = 4, perThread = 2000000;
+        ConcurrentBitmap seen(universe);
+        atomic<long long> claimed(0);
+
+        auto t0 = chrono::high_resolution_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&seen, &claimed, t, perThread, universe]() {
+                // 各线程的编号序列相互重叠
+                unsigned int seed = 777 + (t & 1);
+                long long mine = 0;
+                for (int i = 0; i < perThread; i++) {
+                    seed = seed * 1103515245u + 12345u;
+                    if (!seen.testAndSet((Rank)((seed >> 4) % universe))) mine++;
+                }
+                claimed += mine;
+            });
+        }
+        for (auto& w : workers) w.join();
+        auto t1 = chrono::high_resolution_clock::now();
+
+        Rank distinct = 0;
+        for (Rank k = 0; k < universe; k++) distinct += seen.test(k) ? 1 : 0;
+        cout << "  " << threads << " 线程插入 " << (long long)threads * perThread << " 次, 耗时 "
+            << chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / 1000.0 << "ms"
+            << ", 认领 " << claimed << " / size() " << seen.size() << " / 实际 " << distinct << endl;
+
+        auto t2 = chrono::high_resolution_clock::now();
+        seen.clearAll();
+        auto t3 = chrono::high_resolution_clock::now();
+        cout << "  并行清零耗时 " << chrono::duration_cast<chrono::microseconds>(t3 - t2).count() / 1000.0
+            << "ms, 清零后 size() " << seen.size() << endl;
+    }
+
+    // 11. 文件映射位图：打开不读入数据，修改后按需同步
+    cout << "\n=== 文件映射位图 MappedBitmap ===" << endl;
+    {
+        char path[] = "mapped_bitmap.bin";
+        const Rank bits = 1 << 27;  // 16MB 文件
+        {
+            MappedBitmap mb(path, bits);
+            for (Rank k = 0; k < bits; k += 4099) mb.set(k);
+            if (!mb.set(bits + 100))      // 越过文件末尾，触发扩展映射
+                cout << "  扩展映射失败" << endl;
+            mb.flush();
+        }
+
+        auto t0 = chrono::high_resolution_clock::now();
+        MappedBitmap mapped(path);
+        auto t1 = chrono::high_resolution_clock::now();
+        Bitmap loaded(path, bits);
+        auto t2 = chrono::high_resolution_clock::now();
+
+        bool ok = mapped.isOpen() && mapped.test(bits + 100) && !mapped.test(1);
+        for (Rank k = 0; k < bits && ok; k += 4099) ok = mapped.test(k) && loaded.test(k);
+        cout << "  映射打开耗时 " << chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / 1000.0
+            << "ms, Bitmap 读入耗时 " << chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0
+            << "ms, 置位数 " << mapped.size() << ", 持久化校验: " << (ok ? "通过" : "失败") << endl;
+    }
+    remove("mapped_bitmap.bin");
+
     return 0;
 }
 
@@ -4,17 +4,56 @@
 #include <chrono>
 #include <algorithm>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include "sortlib.h"
 
 using namespace std;
 using namespace chrono;
 
+// 基准测试计数器：比较/交换/搬运次数只由计数类型CountedBox在不计时的计数运行中累加（可能来自多个线程）；
+// IoU计算次数只在定义COUNT_IOU编译时由calculateIoU和各向量化NMS累加，
+// 默认编译下计数代码不存在，计时与正式使用都不受影响
+struct BenchCounters {
+    atomic<long long> comparisons{ 0 }, swaps{ 0 }, moves{ 0 }, iouEvaluations{ 0 };
+
+    void reset() {
+        comparisons = 0;
+        swaps = 0;
+        moves = 0;
+        iouEvaluations = 0;
+    }
+};
+BenchCounters benchCounters;
+
+#ifdef COUNT_IOU
+#define COUNT_IOU_EVALS(k) (benchCounters.iouEvaluations.fetch_add((k), memory_order_relaxed))
+#else
+#define COUNT_IOU_EVALS(k) ((void)0)
+#endif
+
 // 边界框数据结构
 struct BoundingBox {
     float x1, y1, x2, y2;  // 左上角和右下角坐标
     float confidence;      // 置信度
+    int classId = 0;       // 类别编号
 
     // 计算两个框的IoU
     float calculateIoU(const BoundingBox& other) const {
+        COUNT_IOU_EVALS(1);
         float interX1 = max(x1, other.x1);
         float interY1 = max(y1, other.y1);
         float interX2 = min(x2, other.x2);
@@ -32,35 +71,31 @@ struct BoundingBox {
 };
 
 // ====================== 排序算法实现 ======================
+// 排序算法统一由common/sortlib.h提供（迭代器区间+比较器+投影），这里按置信度降序包装成原来的接口。
+// 递归归并排序与Lomuto快速排序是本实验最初的写法，留作性能对比的基线
+
+// 投影：取框的置信度（返回引用，计数类型CountedBox的比较仍会被计数）
+struct ConfidenceOf {
+    template <typename T>
+    auto operator()(const T& b) const -> decltype((b.confidence)) { return b.confidence; }
+};
+
+// 投影：取置信度的float值，供基数排序编码
+struct ConfidenceValue {
+    template <typename T>
+    float operator()(const T& b) const { return b.confidence; }
+};
+
 // 1. 冒泡排序（按置信度降序）
 template <typename T>
 void bubbleSort(vector<T>& arr) {
-    int n = arr.size();
-    for (int i = 0; i < n - 1; ++i) {
-        bool swapped = false;
-        for (int j = 0; j < n - i - 1; ++j) {
-            if (arr[j].confidence < arr[j + 1].confidence) {
-                swap(arr[j], arr[j + 1]);
-                swapped = true;
-            }
-        }
-        if (!swapped) break;
-    }
+    sortlib::bubbleSort(arr.begin(), arr.end(), greater<>(), ConfidenceOf());
 }
 
 // 2. 插入排序（按置信度降序）
 template <typename T>
 void insertionSort(vector<T>& arr) {
-    int n = arr.size();
-    for (int i = 1; i < n; ++i) {
-        T key = arr[i];
-        int j = i - 1;
-        while (j >= 0 && arr[j].confidence < key.confidence) {
-            arr[j + 1] = arr[j];
-            j--;
-        }
-        arr[j + 1] = key;
-    }
+    sortlib::insertionSort(arr.begin(), arr.end(), greater<>(), ConfidenceOf());
 }
 
 // 归并排序辅助函数
@@ -99,7 +134,7 @@ void merge(vector<T>& arr, int left, int mid, int right) {
     }
 }
 
-// 3. 归并排序（按置信度降序）
+// 3. 归并排序（按置信度降序，递归版基线，每次合并都分配临时数组）
 template <typename T>
 void mergeSort(vector<T>& arr, int left, int right) {
     if (left >= right) return;
@@ -109,10 +144,22 @@ void mergeSort(vector<T>& arr, int left, int right) {
     merge(arr, left, mid, right);
 }
 
-// 快速排序分区函数
+// 4. 自底向上归并排序（按置信度降序，稳定，只分配一次缓冲区）
+template <typename T>
+void bottomUpMergeSort(vector<T>& arr) {
+    sortlib::mergeSort(arr.begin(), arr.end(), greater<>(), ConfidenceOf());
+}
+
+// 5. 自然归并排序（按置信度降序，稳定，接近有序时O(n)）
+template <typename T>
+void naturalMergeSort(vector<T>& arr) {
+    sortlib::naturalMergeSort(arr.begin(), arr.end(), greater<>(), ConfidenceOf());
+}
+
+// 朴素快速排序的Lomuto分区函数（以末元素为基准）
 template <typename T>
-int partition(vector<T>& arr, int low, int high) {
-    float pivot = arr[high].confidence;
+int lomutoPartition(vector<T>& arr, int low, int high) {
+    auto pivot = arr[high].confidence;
     int i = low - 1;
     for (int j = low; j < high; ++j) {
         if (arr[j].confidence >= pivot) {
@@ -124,20 +171,44 @@ int partition(vector<T>& arr, int low, int high) {
     return i + 1;
 }
 
-// 4. 快速排序（按置信度降序）
+// 朴素快速排序（保留作对比）：有序或大量相同键时退化为O(n^2)，递归深度可达n
 template <typename T>
-void quickSort(vector<T>& arr, int low, int high) {
+void lomutoQuickSort(vector<T>& arr, int low, int high) {
     if (low < high) {
-        int pi = partition(arr, low, high);
-        quickSort(arr, low, pi - 1);
-        quickSort(arr, pi + 1, high);
+        int pi = lomutoPartition(arr, low, high);
+        lomutoQuickSort(arr, low, pi - 1);
+        lomutoQuickSort(arr, pi + 1, high);
     }
 }
 
+// 6. 快速排序（按置信度降序，对[low, high]做内省式快速排序）
+template <typename T>
+void quickSort(vector<T>& arr, int low, int high) {
+    if (low >= high) return;
+    sortlib::quickSort(arr.begin() + low, arr.begin() + high + 1, greater<>(), ConfidenceOf());
+}
+
+// 7. 基数排序（按置信度降序，稳定）；radixSortIndices只给出排序后的原下标，不移动元素
+template <typename T>
+void radixSortIndices(const vector<T>& arr, vector<int>& order) {
+    sortlib::radixSortOrder(arr.begin(), arr.end(), order, greater<>(), ConfidenceValue());
+}
+
+template <typename T>
+void radixSort(vector<T>& arr) {
+    sortlib::radixSort(arr.begin(), arr.end(), greater<>(), ConfidenceValue());
+}
+
+// 8. 多线程基数排序（结果与radixSort相同）
+template <typename T>
+void parallelRadixSort(vector<T>& arr, int numThreads = 0) {
+    sortlib::parallelRadixSort(arr.begin(), arr.end(), greater<>(), ConfidenceValue(), numThreads);
+}
+
 // ====================== 数据生成函数 ======================
-// 随机数生成器初始化
-random_device rd;
-mt19937 gen(rd());
+// 随机数生成器初始化（固定种子，每次运行生成的数据相同；基准测试按规模重新播种）
+const unsigned DEFAULT_SEED = 2025;
+mt19937 gen(DEFAULT_SEED);
 uniform_real_distribution<float> coordDist(0.0f, 1000.0f);  // 坐标范围0~1000
 uniform_real_distribution<float> sizeDist(10.0f, 50.0f);    // 框大小10~50
 uniform_real_distribution<float> confDist(0.0f, 1.0f);      // 置信度0~1
@@ -182,15 +253,22 @@ vector<BoundingBox> generateClusteredBoxes(int num) {
     return boxes;
 }
 
+// 3. 给每个框随机指定类别0~numClasses-1
+void assignRandomClasses(vector<BoundingBox>& boxes, int numClasses) {
+    uniform_int_distribution<int> classDist(0, numClasses - 1);
+    for (auto& b : boxes) b.classId = classDist(gen);
+}
+
 // ====================== NMS算法实现 ======================
-// 基础NMS（传入排序后的框，IoU阈值可配置）
-vector<BoundingBox> basicNMS(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f) {
+// 基础NMS（传入排序后的框，IoU阈值可配置；maxDetections>0时保留到该数目即结束）
+vector<BoundingBox> basicNMS(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f, int maxDetections = 0) {
     vector<BoundingBox> result;
     vector<bool> suppressed(sortedBoxes.size(), false);
 
     for (int i = 0; i < sortedBoxes.size(); ++i) {
         if (suppressed[i]) continue;
         result.push_back(sortedBoxes[i]);
+        if (maxDetections > 0 && (int)result.size() >= maxDetections) break;
         for (int j = i + 1; j < sortedBoxes.size(); ++j) {
             if (suppressed[j]) continue;
             float iou = sortedBoxes[i].calculateIoU(sortedBoxes[j]);
@@ -202,70 +280,1432 @@ vector<BoundingBox> basicNMS(const vector<BoundingBox>& sortedBoxes, float iouTh
     return result;
 }
 
+// 均匀网格空间索引：按框的平均尺寸划分格子，框登记在它覆盖的每个格子里。
+// 两框有交集时交集区域必落在二者共同覆盖的某个格子中，查询只需检查同格的框。
+// 各缓冲区在多次build之间复用
+class BoxGrid {
+public:
+    // 按boxes的范围与尺寸确定网格，清空登记；编号须小于maxId
+    void build(const vector<BoundingBox>& boxes, int maxId) {
+        int n = boxes.size();
+        float minX = 0, minY = 0, maxX = 1, maxY = 1;
+        double sumSize = 0;
+        if (n > 0) {
+            minX = boxes[0].x1; minY = boxes[0].y1; maxX = boxes[0].x2; maxY = boxes[0].y2;
+        }
+        for (const auto& b : boxes) {
+            minX = min(minX, b.x1);
+            minY = min(minY, b.y1);
+            maxX = max(maxX, b.x2);
+            maxY = max(maxY, b.y2);
+            sumSize += max(b.x2 - b.x1, b.y2 - b.y1);
+        }
+        // 格子边长取平均框尺寸，格子数不超过框数的4倍
+        cellSize = max((float)(sumSize / max(n, 1)), 1e-3f);
+        float w = maxX - minX, h = maxY - minY;
+        while ((double)(w / cellSize + 1) * (h / cellSize + 1) > 4.0 * n + 16) cellSize *= 2;
+        originX = minX;
+        originY = minY;
+        cols = (int)(w / cellSize) + 1;
+        rows = (int)(h / cellSize) + 1;
+
+        head.assign(cols * rows, -1);
+        next.clear();
+        entryId.clear();
+        stamp.assign(maxId, -1);
+        removed.assign(maxId, 0);
+        queryCount = 0;
+    }
+
+    void cellRange(const BoundingBox& b, int& cx1, int& cy1, int& cx2, int& cy2) const {
+        cx1 = min(cols - 1, max(0, (int)((b.x1 - originX) / cellSize)));
+        cy1 = min(rows - 1, max(0, (int)((b.y1 - originY) / cellSize)));
+        cx2 = min(cols - 1, max(0, (int)((b.x2 - originX) / cellSize)));
+        cy2 = min(rows - 1, max(0, (int)((b.y2 - originY) / cellSize)));
+    }
+
+    // 把编号id登记到格子区间[cx1,cx2]x[cy1,cy2]
+    void insertCells(int id, int cx1, int cy1, int cx2, int cy2) {
+        for (int cy = cy1; cy <= cy2; ++cy) {
+            for (int cx = cx1; cx <= cx2; ++cx) {
+                entryId.push_back(id);
+                next.push_back(head[cy * cols + cx]);
+                head[cy * cols + cx] = entryId.size() - 1;
+            }
+        }
+    }
+
+    void insert(int id, const BoundingBox& b) {
+        int cx1, cy1, cx2, cy2;
+        cellRange(b, cx1, cy1, cx2, cy2);
+        insertCells(id, cx1, cy1, cx2, cy2);
+    }
+
+    // 注销编号id，它的登记项在之后的查询中顺带从链表摘除
+    void erase(int id) { removed[id] = 1; }
+
+    // 依次访问与b共格的编号（每个只访问一次），visit返回true时停止并返回true
+    template <typename Visit>
+    bool forEachNear(const BoundingBox& b, Visit visit) {
+        int cx1, cy1, cx2, cy2;
+        cellRange(b, cx1, cy1, cx2, cy2);
+        int q = queryCount++;
+        for (int cy = cy1; cy <= cy2; ++cy) {
+            for (int cx = cx1; cx <= cx2; ++cx) {
+                int* link = &head[cy * cols + cx];
+                for (int e = *link; e >= 0; e = *link) {
+                    int id = entryId[e];
+                    if (removed[id]) {
+                        *link = next[e];
+                        continue;
+                    }
+                    link = &next[e];
+                    if (stamp[id] == q) continue;  // 跨多个格子的框只访问一次
+                    stamp[id] = q;
+                    if (visit(id)) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    vector<int> head;      // 每个格子链表的首个登记项
+    vector<int> next;      // 登记项的后继
+    vector<int> entryId;   // 登记项对应的编号
+    vector<int> stamp;     // 编号最近一次被哪次查询访问过
+    vector<char> removed;  // 已注销的编号
+    int queryCount = 0;
+    float originX = 0, originY = 0, cellSize = 1;
+    int cols = 1, rows = 1;
+};
+
+// 网格加速NMS：已保留的框登记到网格中，新框只与共格的已保留框计算IoU。
+// IoU>阈值(>=0)必然有交集，因此保留结果与basicNMS完全一致
+class GridNMS {
+public:
+    vector<BoundingBox> run(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f, int maxDetections = 0) {
+        if (iouThreshold < 0) return basicNMS(sortedBoxes, iouThreshold, maxDetections);  // 此时不相交的框也会互相抑制
+        vector<BoundingBox> result;
+        runIndices(sortedBoxes, iouThreshold, maxDetections, keep);
+        for (int k : keep) result.push_back(sortedBoxes[k]);
+        return result;
+    }
+
+    // 保留框的下标写入keep（要求iouThreshold>=0）
+    void runIndices(const vector<BoundingBox>& sortedBoxes, float iouThreshold, int maxDetections, vector<int>& keep) {
+        keep.clear();
+        int n = sortedBoxes.size();
+        grid.build(sortedBoxes, n);
+        for (int j = 0; j < n; ++j) {
+            const BoundingBox& cand = sortedBoxes[j];
+            bool suppressed = grid.forEachNear(cand, [&](int k) {
+                return sortedBoxes[k].calculateIoU(cand) > iouThreshold;
+            });
+            if (suppressed) continue;
+            keep.push_back(j);
+            if (maxDetections > 0 && (int)keep.size() >= maxDetections) break;
+            grid.insert(j, cand);
+        }
+    }
+
+private:
+    BoxGrid grid;
+    vector<int> keep;
+};
+
+// ====================== SoA批量IoU与向量化NMS ======================
+// 结构数组形式的框批量：各坐标分列连续存放，面积预先算好，长度补齐到8的倍数
+struct BoxBatch {
+    vector<float> x1, y1, x2, y2, area;
+    int n = 0;
+
+    void assign(const vector<BoundingBox>& boxes) {
+        n = boxes.size();
+        int padded = (n + 7) / 8 * 8;
+        // 补齐部分全为0，退化框与任何框都无交集
+        x1.assign(padded, 0.0f);
+        y1.assign(padded, 0.0f);
+        x2.assign(padded, 0.0f);
+        y2.assign(padded, 0.0f);
+        area.assign(padded, 0.0f);
+        for (int i = 0; i < n; ++i) {
+            x1[i] = boxes[i].x1;
+            y1[i] = boxes[i].y1;
+            x2[i] = boxes[i].x2;
+            y2[i] = boxes[i].y2;
+            area[i] = (x2[i] - x1[i]) * (y2[i] - y1[i]);
+        }
+    }
+};
+
+// 框i与框j0~j0+7的IoU是否大于阈值，第k位对应框j0+k。
+// 运算顺序与calculateIoU相同（并集 = 面积i + 面积j - 交集），结果逐位一致
+unsigned int iouMask8(const BoxBatch& b, int i, int j0, float iouThreshold) {
+#if defined(__AVX__)
+    __m256 ix1 = _mm256_max_ps(_mm256_set1_ps(b.x1[i]), _mm256_loadu_ps(&b.x1[j0]));
+    __m256 iy1 = _mm256_max_ps(_mm256_set1_ps(b.y1[i]), _mm256_loadu_ps(&b.y1[j0]));
+    __m256 ix2 = _mm256_min_ps(_mm256_set1_ps(b.x2[i]), _mm256_loadu_ps(&b.x2[j0]));
+    __m256 iy2 = _mm256_min_ps(_mm256_set1_ps(b.y2[i]), _mm256_loadu_ps(&b.y2[j0]));
+    __m256 valid = _mm256_and_ps(_mm256_cmp_ps(ix1, ix2, _CMP_LT_OQ), _mm256_cmp_ps(iy1, iy2, _CMP_LT_OQ));
+    __m256 inter = _mm256_mul_ps(_mm256_sub_ps(ix2, ix1), _mm256_sub_ps(iy2, iy1));
+    __m256 uni = _mm256_sub_ps(_mm256_add_ps(_mm256_set1_ps(b.area[i]), _mm256_loadu_ps(&b.area[j0])), inter);
+    __m256 iou = _mm256_div_ps(inter, uni);
+    __m256 hit = _mm256_and_ps(valid, _mm256_cmp_ps(iou, _mm256_set1_ps(iouThreshold), _CMP_GT_OQ));
+    return (unsigned int)_mm256_movemask_ps(hit);
+#elif defined(__SSE2__) || defined(_M_X64)
+    unsigned int mask = 0;
+    for (int h = 0; h < 8; h += 4) {
+        __m128 ix1 = _mm_max_ps(_mm_set1_ps(b.x1[i]), _mm_loadu_ps(&b.x1[j0 + h]));
+        __m128 iy1 = _mm_max_ps(_mm_set1_ps(b.y1[i]), _mm_loadu_ps(&b.y1[j0 + h]));
+        __m128 ix2 = _mm_min_ps(_mm_set1_ps(b.x2[i]), _mm_loadu_ps(&b.x2[j0 + h]));
+        __m128 iy2 = _mm_min_ps(_mm_set1_ps(b.y2[i]), _mm_loadu_ps(&b.y2[j0 + h]));
+        __m128 valid = _mm_and_ps(_mm_cmplt_ps(ix1, ix2), _mm_cmplt_ps(iy1, iy2));
+        __m128 inter = _mm_mul_ps(_mm_sub_ps(ix2, ix1), _mm_sub_ps(iy2, iy1));
+        __m128 uni = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(b.area[i]), _mm_loadu_ps(&b.area[j0 + h])), inter);
+        __m128 iou = _mm_div_ps(inter, uni);
+        __m128 hit = _mm_and_ps(valid, _mm_cmpgt_ps(iou, _mm_set1_ps(iouThreshold)));
+        mask |= (unsigned int)_mm_movemask_ps(hit) << h;
+    }
+    return mask;
+#else
+    unsigned int mask = 0;
+    for (int k = 0; k < 8; ++k) {
+        int j = j0 + k;
+        float ix1 = max(b.x1[i], b.x1[j]), iy1 = max(b.y1[i], b.y1[j]);
+        float ix2 = min(b.x2[i], b.x2[j]), iy2 = min(b.y2[i], b.y2[j]);
+        if (ix1 >= ix2 || iy1 >= iy2) continue;
+        float inter = (ix2 - ix1) * (iy2 - iy1);
+        if (inter / (b.area[i] + b.area[j] - inter) > iouThreshold) mask |= 1u << k;
+    }
+    return mask;
+#endif
+}
+
+// 向量化NMS：与basicNMS流程相同，内层每次处理8个框，抑制标记存为位掩码
+class VectorizedNMS {
+public:
+    vector<BoundingBox> run(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f, int maxDetections = 0) {
+        if (iouThreshold < 0) return basicNMS(sortedBoxes, iouThreshold, maxDetections);  // 不相交的框也会互相抑制
+        vector<BoundingBox> result;
+        int n = sortedBoxes.size();
+        batch.assign(sortedBoxes);
+        removed.assign((n + 63) / 64, 0);
+
+        for (int i = 0; i < n; ++i) {
+            if ((removed[i >> 6] >> (i & 63)) & 1) continue;
+            result.push_back(sortedBoxes[i]);
+            if (maxDetections > 0 && (int)result.size() >= maxDetections) break;
+            // 从i+1所在的8框组开始，组内不晚于i的位屏蔽掉
+            for (int j0 = (i + 1) & ~7; j0 < n; j0 += 8) {
+                unsigned int group = (unsigned int)(removed[j0 >> 6] >> (j0 & 63)) & 0xFF;
+                if (group == 0xFF) continue;  // 整组已被抑制
+                unsigned int mask = iouMask8(batch, i, j0, iouThreshold) & ~group;
+                COUNT_IOU_EVALS(8);
+                if (j0 <= i) mask &= ~0u << (i + 1 - j0);
+                removed[j0 >> 6] |= (unsigned long long)mask << (j0 & 63);
+            }
+        }
+        return result;
+    }
+
+private:
+    BoxBatch batch;                     // 复用的SoA缓冲
+    vector<unsigned long long> removed; // 抑制位掩码
+};
+
+// ====================== 多线程位掩码矩阵NMS ======================
+// 仿GPU上的bitmask NMS：先多线程计算上三角重叠矩阵，第i行按64框一组存成位掩码
+// （第j位表示框j在i之后且与i的IoU大于阈值），再顺序扫描，把保留框的行掩码或到抑制位上。
+// 矩阵按行分段计算，每段算完即扫描，内存只占一段；前面各段已抑制的行不再计算
+class BitmaskNMS {
+public:
+    explicit BitmaskNMS(int threads = 0)
+        : numThreads(threads > 0 ? threads : max(1u, thread::hardware_concurrency())) {}
+
+    vector<BoundingBox> run(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f, int maxDetections = 0) {
+        if (iouThreshold < 0) return basicNMS(sortedBoxes, iouThreshold, maxDetections);  // 不相交的框也会互相抑制
+        vector<BoundingBox> result;
+        int n = sortedBoxes.size();
+        int blocks = (n + 63) / 64;
+        batch.assign(sortedBoxes);
+        removed.assign(blocks, 0);
+
+        // 每段行数使段内掩码约为4M个字（32MB）
+        int panelRows = max(64, min(n, (int)(4 * 1024 * 1024 / max(1, blocks))));
+        matrix.resize((size_t)panelRows * blocks);
+
+        for (int r0 = 0; r0 < n; r0 += panelRows) {
+            int r1 = min(n, r0 + panelRows);
+            // 行交错分给各线程，使上三角的工作量均衡
+            vector<thread> workers;
+            for (int t = 0; t < numThreads; ++t) {
+                workers.emplace_back([this, t, r0, r1, blocks, iouThreshold]() {
+                    for (int i = r0 + t; i < r1; i += numThreads) {
+                        if ((removed[i >> 6] >> (i & 63)) & 1) continue;
+                        computeRow(i, &matrix[(size_t)(i - r0) * blocks], blocks, iouThreshold);
+                    }
+                });
+            }
+            for (auto& w : workers) w.join();
+
+            for (int i = r0; i < r1; ++i) {
+                if ((removed[i >> 6] >> (i & 63)) & 1) continue;
+                result.push_back(sortedBoxes[i]);
+                if (maxDetections > 0 && (int)result.size() >= maxDetections) return result;
+                const unsigned long long* row = &matrix[(size_t)(i - r0) * blocks];
+                for (int b = i >> 6; b < blocks; ++b) removed[b] |= row[b];
+            }
+        }
+        return result;
+    }
+
+private:
+    int numThreads;
+    BoxBatch batch;                     // 以下缓冲区在多次调用间复用
+    vector<unsigned long long> removed; // 抑制位，计算阶段只读
+    vector<unsigned long long> matrix;  // 当前段的行掩码
+
+    // 计算第i行从i所在组开始的各组掩码，不晚于i的位清零
+    void computeRow(int i, unsigned long long* row, int blocks, float iouThreshold) const {
+        for (int b = i >> 6; b < blocks; ++b) {
+            unsigned long long mask = 0;
+            int end = min(batch.n, (b + 1) * 64);
+            for (int j0 = b * 64; j0 < end; j0 += 8) {
+                mask |= (unsigned long long)iouMask8(batch, i, j0, iouThreshold) << (j0 & 63);
+                COUNT_IOU_EVALS(8);
+            }
+            if (b == (i >> 6)) mask &= (i & 63) == 63 ? 0 : ~0ULL << ((i & 63) + 1);
+            row[b] = mask;
+        }
+    }
+};
+
+// ====================== Soft-NMS、分类别批量NMS与加权框融合 ======================
+// Soft-NMS：重叠框不直接删除，而是按IoU衰减置信度，低于scoreThreshold才丢弃。
+// 每轮取当前置信度最高的框（带位置索引的最大堆，衰减后原地下沉），只对网格中与它共格的框做衰减。
+// 输入无需排序，输出按选出顺序排列，置信度为衰减后的值
+class SoftNMS {
+public:
+    enum Method { LINEAR, GAUSSIAN };
+
+    // LINEAR：IoU>iouThreshold时置信度乘(1-IoU)；GAUSSIAN：乘exp(-IoU^2/sigma)
+    SoftNMS(Method m = GAUSSIAN, float sigma = 0.5f, float iouThreshold = 0.3f, float scoreThreshold = 0.001f)
+        : method(m), sigma(sigma), iouThreshold(iouThreshold), scoreThreshold(scoreThreshold) {}
+
+    vector<BoundingBox> run(const vector<BoundingBox>& boxes, int maxDetections = 0) {
+        vector<BoundingBox> result;
+        int n = boxes.size();
+        grid.build(boxes, n);
+        scores.resize(n);
+        pos.assign(n, -1);
+        heap.clear();
+        for (int i = 0; i < n; ++i) {
+            scores[i] = boxes[i].confidence;
+            if (scores[i] < scoreThreshold) continue;
+            grid.insert(i, boxes[i]);
+            pos[i] = heap.size();
+            heap.push_back(i);
+        }
+        for (int k = (int)heap.size() / 2 - 1; k >= 0; --k) siftDown(k);
+
+        while (!heap.empty()) {
+            int i = heap[0];
+            removeAt(0);
+            grid.erase(i);
+            result.push_back(boxes[i]);
+            result.back().confidence = scores[i];
+            if (maxDetections > 0 && (int)result.size() >= maxDetections) break;
+
+            grid.forEachNear(boxes[i], [&](int j) {
+                float iou = boxes[i].calculateIoU(boxes[j]);
+                if (iou <= 0) return false;
+                if (method == LINEAR) {
+                    if (iou <= iouThreshold) return false;
+                    scores[j] *= 1.0f - iou;
+                }
+                else {
+                    scores[j] *= exp(-iou * iou / sigma);
+                }
+                if (scores[j] < scoreThreshold) {
+                    removeAt(pos[j]);
+                    grid.erase(j);
+                }
+                else {
+                    siftDown(pos[j]);
+                }
+                return false;
+            });
+        }
+        return result;
+    }
+
+private:
+    Method method;
+    float sigma, iouThreshold, scoreThreshold;
+    BoxGrid grid;                     // 以下缓冲区在多次调用间复用
+    vector<float> scores;             // 当前（衰减后的）置信度
+    vector<int> heap;                 // 待选框下标组成的最大堆
+    vector<int> pos;                  // 下标在堆中的位置，-1表示不在堆中
+
+    // 置信度高者优先，相同时下标小者优先
+    bool higher(int a, int b) const {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    }
+
+    void place(int k, int id) {
+        heap[k] = id;
+        pos[id] = k;
+    }
+
+    void siftDown(int k) {
+        int id = heap[k], n = heap.size();
+        while (2 * k + 1 < n) {
+            int c = 2 * k + 1;
+            if (c + 1 < n && higher(heap[c + 1], heap[c])) c++;
+            if (!higher(heap[c], id)) break;
+            place(k, heap[c]);
+            k = c;
+        }
+        place(k, id);
+    }
+
+    void siftUp(int k) {
+        int id = heap[k];
+        while (k > 0 && higher(id, heap[(k - 1) / 2])) {
+            place(k, heap[(k - 1) / 2]);
+            k = (k - 1) / 2;
+        }
+        place(k, id);
+    }
+
+    void removeAt(int k) {
+        int id = heap[k];
+        int last = heap.back();
+        heap.pop_back();
+        pos[id] = -1;
+        if (k < (int)heap.size()) {
+            place(k, last);
+            siftUp(k);
+            siftDown(pos[last]);
+        }
+    }
+};
+
+// 分类别批量NMS：各类别的框沿x方向整体平移classId*偏移量（偏移量大于坐标跨度）后登记到网格，
+// 不同类别的框落在不同格子里，一趟网格NMS即可代替逐类别多趟NMS。
+// 平移只用于分格，IoU仍用原坐标计算，结果与逐类别做NMS完全一致
+class BatchedNMS {
+public:
+    vector<BoundingBox> run(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f, int maxDetections = 0) {
+        if (iouThreshold < 0) return basicPerClass(sortedBoxes, iouThreshold, maxDetections);  // 不相交的框也会互相抑制
+        vector<BoundingBox> result;
+        int n = sortedBoxes.size();
+        if (n == 0) return result;
+        float minX = sortedBoxes[0].x1, maxX = sortedBoxes[0].x2;
+        for (const auto& b : sortedBoxes) {
+            minX = min(minX, b.x1);
+            maxX = max(maxX, b.x2);
+        }
+        float offset = maxX - minX + 1.0f;
+
+        shifted = sortedBoxes;
+        for (auto& b : shifted) {
+            b.x1 += b.classId * offset;
+            b.x2 += b.classId * offset;
+        }
+        grid.build(shifted, n);
+        for (int j = 0; j < n; ++j) {
+            const BoundingBox& cand = sortedBoxes[j];
+            bool suppressed = grid.forEachNear(shifted[j], [&](int k) {
+                return sortedBoxes[k].classId == cand.classId &&
+                    sortedBoxes[k].calculateIoU(cand) > iouThreshold;
+            });
+            if (suppressed) continue;
+            result.push_back(cand);
+            if (maxDetections > 0 && (int)result.size() >= maxDetections) break;
+            grid.insert(j, shifted[j]);
+        }
+        return result;
+    }
+
+private:
+    BoxGrid grid;                     // 以下缓冲区在多次调用间复用
+    vector<BoundingBox> shifted;
+
+    // 逐类别的基础NMS：新框与同类别中已保留的每个框比较，结果顺序与输入一致
+    static vector<BoundingBox> basicPerClass(const vector<BoundingBox>& sortedBoxes, float iouThreshold, int maxDetections) {
+        vector<BoundingBox> result;
+        for (const auto& cand : sortedBoxes) {
+            bool suppressed = false;
+            for (const auto& k : result) {
+                if (k.classId == cand.classId && k.calculateIoU(cand) > iouThreshold) {
+                    suppressed = true;
+                    break;
+                }
+            }
+            if (suppressed) continue;
+            result.push_back(cand);
+            if (maxDetections > 0 && (int)result.size() >= maxDetections) break;
+        }
+        return result;
+    }
+};
+
+// 加权框融合（WBF）：按置信度从高到低，每个框并入同类别中与它IoU最大且超过阈值的融合框，
+// 否则自成一个新融合框。融合框坐标为成员按置信度加权的平均，置信度为成员平均值。
+// 融合框登记在网格中，坐标变化后补登记新覆盖的格子
+class WeightedBoxFusion {
+public:
+    vector<BoundingBox> run(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.55f) {
+        int n = sortedBoxes.size();
+        grid.build(sortedBoxes, n);
+        clusters.clear();
+        fused.clear();
+
+        for (const auto& b : sortedBoxes) {
+            int best = -1;
+            float bestIoU = iouThreshold;
+            grid.forEachNear(b, [&](int c) {
+                if (fused[c].classId != b.classId) return false;
+                float iou = fused[c].calculateIoU(b);
+                if (iou > bestIoU) {
+                    bestIoU = iou;
+                    best = c;
+                }
+                return false;
+            });
+
+            if (best < 0) {
+                Cluster c;
+                c.sumW = b.confidence;
+                c.sumX1 = (double)b.confidence * b.x1;
+                c.sumY1 = (double)b.confidence * b.y1;
+                c.sumX2 = (double)b.confidence * b.x2;
+                c.sumY2 = (double)b.confidence * b.y2;
+                c.count = 1;
+                grid.cellRange(b, c.cx1, c.cy1, c.cx2, c.cy2);
+                grid.insertCells(clusters.size(), c.cx1, c.cy1, c.cx2, c.cy2);
+                clusters.push_back(c);
+                fused.push_back(b);
+                continue;
+            }
+
+            Cluster& c = clusters[best];
+            c.sumW += b.confidence;
+            c.sumX1 += (double)b.confidence * b.x1;
+            c.sumY1 += (double)b.confidence * b.y1;
+            c.sumX2 += (double)b.confidence * b.x2;
+            c.sumY2 += (double)b.confidence * b.y2;
+            c.count++;
+            BoundingBox& f = fused[best];
+            if (c.sumW > 0) {
+                f.x1 = (float)(c.sumX1 / c.sumW);
+                f.y1 = (float)(c.sumY1 / c.sumW);
+                f.x2 = (float)(c.sumX2 / c.sumW);
+                f.y2 = (float)(c.sumY2 / c.sumW);
+            }
+            f.confidence = (float)(c.sumW / c.count);
+
+            // 只补登记超出原范围的格子
+            int cx1, cy1, cx2, cy2;
+            grid.cellRange(f, cx1, cy1, cx2, cy2);
+            for (int cy = cy1; cy <= cy2; ++cy) {
+                for (int cx = cx1; cx <= cx2; ++cx) {
+                    if (cx < c.cx1 || cx > c.cx2 || cy < c.cy1 || cy > c.cy2) grid.insertCells(best, cx, cy, cx, cy);
+                }
+            }
+            c.cx1 = min(c.cx1, cx1);
+            c.cy1 = min(c.cy1, cy1);
+            c.cx2 = max(c.cx2, cx2);
+            c.cy2 = max(c.cy2, cy2);
+        }
+        return fused;
+    }
+
+private:
+    struct Cluster {
+        double sumW, sumX1, sumY1, sumX2, sumY2;  // 置信度之和与加权坐标之和
+        int count;
+        int cx1, cy1, cx2, cy2;                   // 已登记的格子范围
+    };
+
+    BoxGrid grid;                     // 以下缓冲区在多次调用间复用
+    vector<Cluster> clusters;
+    vector<BoundingBox> fused;
+};
+
+// ====================== 视频流逐帧NMS ======================
+// 视频相邻帧中大部分检测框原地不动。与上一帧坐标和类别完全相同的框视为未移动，用开放寻址哈希表按坐标认领，
+// 不需要查网格；两个框都未移动时它们的IoU不变，直接沿用上一帧记下的重叠关系（IoU>阈值的框对）。
+// 只有移动过的框和新框查一遍全部框的网格，补齐与它们有关的重叠关系。
+// 最后按本帧的置信度顺序在重叠关系上做一遍贪心：框与已保留的某个框重叠则被抑制。
+// 重叠关系是完整的，置信度变化导致的先后变化也照常处理，因此结果与逐帧独立做GridNMS完全相同。
+// 所有缓冲区在帧间复用，每帧最多处理maxBoxes个框（输入须按置信度降序，超出部分丢弃）
+class StreamingNMS {
+public:
+    explicit StreamingNMS(int maxBoxes = 20000, float iouThreshold = 0.5f)
+        : maxBoxes(maxBoxes), iouThreshold(iouThreshold) {}
+
+    // 处理一帧，返回本帧保留的框（按置信度降序），引用在下一次调用前有效
+    const vector<BoundingBox>& processFrame(const vector<BoundingBox>& sortedBoxes) {
+        int n = min((int)sortedBoxes.size(), maxBoxes);
+        frame.assign(sortedBoxes.begin(), sortedBoxes.begin() + n);
+        if (iouThreshold < 0) {  // 不相交的框也会互相抑制，网格不再适用
+            result = basicNMS(frame, iouThreshold);
+            reset();
+            return result;
+        }
+
+        // 1. 按坐标认领上一帧的框；本帧内坐标重复的框下一帧不参与认领
+        size_t mask = 1;
+        while (mask < 2 * (size_t)n) mask <<= 1;
+        table.assign(mask--, -1);
+        dup.assign(n, 0);
+        prevOf.assign(n, -1);
+        curOf.assign(prevCount, -1);
+        staticCount = 0;
+        size_t prevMask = prevTable.size() - 1;
+        for (int j = 0; j < n; ++j) {
+            size_t h = hashBox(frame[j]);
+            for (size_t s = h & mask; ; s = (s + 1) & mask) {
+                int e = table[s];
+                if (e < 0) {
+                    table[s] = j;
+                    break;
+                }
+                if (sameKey(frame[e], frame[j])) {
+                    dup[e] = dup[j] = 1;
+                    break;
+                }
+            }
+            if (prevCount == 0) continue;
+            for (size_t s = h & prevMask; prevTable[s] >= 0; s = (s + 1) & prevMask) {
+                int p = prevTable[s];
+                if (!sameKey(prevFrame[p], frame[j])) continue;
+                if (!prevDup[p] && curOf[p] < 0) {
+                    prevOf[j] = p;
+                    curOf[p] = j;
+                    staticCount++;
+                }
+                break;
+            }
+        }
+
+        // 2. 未移动的框之间沿用上一帧的重叠关系（上一帧的邻接表是对称的，两个方向都会加入）
+        edges.clear();
+        for (int j = 0; j < n; ++j) {
+            int p = prevOf[j];
+            if (p < 0) continue;
+            for (int e = prevOffset[p]; e < prevOffset[p + 1]; ++e) {
+                int k = curOf[prevAdj[e]];
+                if (k >= 0) edges.push_back({ j, k });
+            }
+        }
+
+        // 3. 移动过的框查网格：与未移动框的关系两个方向都加入，与移动过的框的关系由双方各加一次
+        grid.build(frame, n);
+        for (int j = 0; j < n; ++j) grid.insert(j, frame[j]);
+        for (int j = 0; j < n; ++j) {
+            if (prevOf[j] >= 0) continue;
+            grid.forEachNear(frame[j], [&](int k) {
+                if (k != j && frame[k].calculateIoU(frame[j]) > iouThreshold) {
+                    edges.push_back({ j, k });
+                    if (prevOf[k] >= 0) edges.push_back({ k, j });
+                }
+                return false;
+            });
+        }
+
+        // 4. 整理成邻接表，留给下一帧沿用
+        curOffset.assign(n + 1, 0);
+        for (const auto& e : edges) curOffset[e.first + 1]++;
+        for (int j = 0; j < n; ++j) curOffset[j + 1] += curOffset[j];
+        curAdj.resize(edges.size());
+        fillPos.assign(curOffset.begin(), curOffset.end() - 1);
+        for (const auto& e : edges) curAdj[fillPos[e.first]++] = e.second;
+
+        // 5. 按置信度顺序贪心
+        kept.assign(n, 0);
+        result.clear();
+        for (int j = 0; j < n; ++j) {
+            bool suppressed = false;
+            for (int e = curOffset[j]; e < curOffset[j + 1] && !suppressed; ++e) suppressed = kept[curAdj[e]];
+            if (suppressed) continue;
+            kept[j] = 1;
+            result.push_back(frame[j]);
+        }
+
+        prevFrame.swap(frame);
+        prevTable.swap(table);
+        prevDup.swap(dup);
+        prevOffset.swap(curOffset);
+        prevAdj.swap(curAdj);
+        prevCount = n;
+        return result;
+    }
+
+    // 开始新的视频流，丢弃上一帧的记录
+    void reset() { prevCount = 0; }
+
+    // 上一次processFrame中未移动、沿用上一帧重叠关系的框数
+    int lastStaticCount() const { return staticCount; }
+
+private:
+    // 按位比较坐标与类别，使哈希与相等判断一致（-0.0与+0.0视为不同坐标，只会少认领，不影响结果）
+    static bool sameKey(const BoundingBox& a, const BoundingBox& b) {
+        return memcmp(&a.x1, &b.x1, 4 * sizeof(float)) == 0 && a.classId == b.classId;
+    }
+
+    static size_t hashBox(const BoundingBox& b) {
+        uint32_t w[4];
+        memcpy(w, &b.x1, sizeof(w));
+        uint64_t h = (uint32_t)b.classId;
+        for (uint32_t x : w) h = (h ^ x) * 0x9E3779B97F4A7C15ULL;
+        return (size_t)(h ^ (h >> 32));
+    }
+
+    int maxBoxes;
+    float iouThreshold;
+    int staticCount = 0, prevCount = 0;
+    vector<BoundingBox> frame, prevFrame, result;
+    vector<int> table, prevTable;                         // 按坐标哈希的开放寻址表，存帧内编号，-1为空
+    vector<char> dup, prevDup;                            // 帧内坐标重复的框
+    vector<int> prevOffset, prevAdj, curOffset, curAdj;   // 重叠关系的邻接表
+    vector<int> prevOf, curOf, fillPos;   // prevOf[j]：本帧框j认领的上一帧编号；curOf[p]：认领上一帧框p的本帧编号
+    vector<pair<int, int>> edges;
+    vector<char> kept;
+    BoxGrid grid;
+};
+
+// ====================== NMS前置筛选 ======================
+// 按置信度降序比较，置信度相同时依次比较坐标，使排序结果唯一
+bool confidenceGreater(const BoundingBox& a, const BoundingBox& b) {
+    if (a.confidence != b.confidence) return a.confidence > b.confidence;
+    if (a.x1 != b.x1) return a.x1 < b.x1;
+    if (a.y1 != b.y1) return a.y1 < b.y1;
+    if (a.x2 != b.x2) return a.x2 < b.x2;
+    return a.y2 < b.y2;
+}
+
+// 丢弃置信度低于scoreThreshold的框，用nth_element选出置信度最高的topK个，只对这些框排序
+// （topK<=0表示不限个数）。低分框只可能被高分框抑制，不会影响高分框的去留，
+// 因此筛选后NMS的保留结果就是完整NMS结果中的前若干个
+vector<BoundingBox> preNMSSelect(const vector<BoundingBox>& boxes, float scoreThreshold, int topK) {
+    vector<BoundingBox> selected;
+    for (const auto& b : boxes) {
+        if (b.confidence >= scoreThreshold) selected.push_back(b);
+    }
+    if (topK > 0 && (int)selected.size() > topK) {
+        nth_element(selected.begin(), selected.begin() + (topK - 1), selected.end(), confidenceGreater);
+        selected.resize(topK);
+    }
+    sort(selected.begin(), selected.end(), confidenceGreater);
+    return selected;
+}
+
 // ====================== 性能测试函数 ======================
-// 测试单个排序算法的耗时（包含NMS整体耗时）
-void testSortPerformance(const string& sortName,
-    void (*sortFunc)(vector<BoundingBox>&),
-    vector<BoundingBox> boxes,
-    const string& distType) {
-    // 计时排序阶段
-    auto startSort = high_resolution_clock::now();
-    if (sortName == "快速排序") {
-        quickSort(boxes, 0, boxes.size() - 1);
-    }
-    else if (sortName == "归并排序") {
-        mergeSort(boxes, 0, boxes.size() - 1);
-    }
-    else {
-        sortFunc(boxes);
-    }
-    auto endSort = high_resolution_clock::now();
-    double sortTime = duration_cast<microseconds>(endSort - startSort).count() / 1000.0;  // 转毫秒
-
-    // 计时NMS阶段
-    auto startNMS = high_resolution_clock::now();
-    vector<BoundingBox> nmsResult = basicNMS(boxes);
-    auto endNMS = high_resolution_clock::now();
-    double nmsTime = duration_cast<microseconds>(endNMS - startNMS).count() / 1000.0;
-
-    // 输出结果
+// 两个框的坐标、置信度和类别是否完全相同
+bool sameBox(const BoundingBox& a, const BoundingBox& b) {
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2 &&
+        a.confidence == b.confidence && a.classId == b.classId;
+}
+
+// 两组框是否逐个相同
+bool sameBoxes(const vector<BoundingBox>& a, const vector<BoundingBox>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!sameBox(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+// 对比basicNMS、向量化NMS、多线程位掩码NMS与网格NMS的耗时，并检查保留结果是否一致
+// （规模过大时两种逐对比较的NMS需数秒，withBasic为false时只测网格NMS）
+void testNMSPerformance(vector<BoundingBox> boxes, const string& distType, bool withBasic = true) {
+    quickSort(boxes, 0, boxes.size() - 1);
+
+    vector<BoundingBox> basicResult;
+    double basicTime = 0;
+    if (withBasic) {
+        auto startBasic = high_resolution_clock::now();
+        basicResult = basicNMS(boxes);
+        auto endBasic = high_resolution_clock::now();
+        basicTime = duration_cast<microseconds>(endBasic - startBasic).count() / 1000.0;
+    }
+
+    vector<BoundingBox> vecResult;
+    double vecTime = 0;
+    if (withBasic) {
+        VectorizedNMS vecNMS;
+        auto startVec = high_resolution_clock::now();
+        vecResult = vecNMS.run(boxes);
+        auto endVec = high_resolution_clock::now();
+        vecTime = duration_cast<microseconds>(endVec - startVec).count() / 1000.0;
+    }
+
+    vector<BoundingBox> maskResult;
+    double maskTime = 0;
+    if (withBasic) {
+        BitmaskNMS maskNMS;
+        auto startMask = high_resolution_clock::now();
+        maskResult = maskNMS.run(boxes);
+        auto endMask = high_resolution_clock::now();
+        maskTime = duration_cast<microseconds>(endMask - startMask).count() / 1000.0;
+    }
+
+    GridNMS gridNMS;
+    auto startGrid = high_resolution_clock::now();
+    vector<BoundingBox> gridResult = gridNMS.run(boxes);
+    auto endGrid = high_resolution_clock::now();
+    double gridTime = duration_cast<microseconds>(endGrid - startGrid).count() / 1000.0;
+
+    cout << "数据分布: " << distType
+        << " | 数据规模: " << boxes.size();
+    if (withBasic) {
+        cout << " | 基础NMS: " << basicTime << "ms | 向量化NMS: " << vecTime << "ms"
+            << " | 位掩码NMS: " << maskTime << "ms";
+    }
+    cout << " | 网格NMS: " << gridTime << "ms"
+        << " | 保留框数: " << gridResult.size();
+    if (withBasic) {
+        cout << " | 结果一致: "
+            << (sameBoxes(basicResult, gridResult) && sameBoxes(basicResult, vecResult) &&
+                sameBoxes(basicResult, maskResult) ? "是" : "否");
+    }
+    cout << endl;
+}
+
+// 对比"全量排序+NMS"与"阈值筛选+TopK+带上限NMS"的耗时
+void testPreNMSPerformance(vector<BoundingBox> boxes, const string& distType,
+    float scoreThreshold = 0.5f, int topK = 1000, int maxDetections = 300) {
+    GridNMS gridNMS;
+
+    vector<BoundingBox> fullBoxes = boxes;
+    auto startFull = high_resolution_clock::now();
+    sort(fullBoxes.begin(), fullBoxes.end(), confidenceGreater);
+    auto midFull = high_resolution_clock::now();
+    vector<BoundingBox> fullResult = gridNMS.run(fullBoxes);
+    auto endFull = high_resolution_clock::now();
+
+    auto startPre = high_resolution_clock::now();
+    vector<BoundingBox> selected = preNMSSelect(boxes, scoreThreshold, topK);
+    auto midPre = high_resolution_clock::now();
+    vector<BoundingBox> preResult = gridNMS.run(selected, 0.5f, maxDetections);
+    auto endPre = high_resolution_clock::now();
+
+    // 筛选后的结果应与完整结果的前缀相同
+    vector<BoundingBox> prefix;
+    for (const auto& b : fullResult) {
+        if (prefix.size() == preResult.size()) break;
+        prefix.push_back(b);
+    }
+
     cout << "数据分布: " << distType
         << " | 数据规模: " << boxes.size()
-        << " | 排序算法: " << sortName
-        << " | 排序耗时: " << sortTime << "ms"
-        << " | NMS耗时: " << nmsTime << "ms"
-        << " | 总耗时: " << (sortTime + nmsTime) << "ms"
-        << " | NMS保留框数: " << nmsResult.size() << endl;
+        << " | 全量排序: " << duration_cast<microseconds>(midFull - startFull).count() / 1000.0 << "ms"
+        << " | 全量NMS: " << duration_cast<microseconds>(endFull - midFull).count() / 1000.0 << "ms"
+        << " | 筛选+TopK排序: " << duration_cast<microseconds>(midPre - startPre).count() / 1000.0 << "ms"
+        << " | 筛选后NMS: " << duration_cast<microseconds>(endPre - midPre).count() / 1000.0 << "ms"
+        << " | 保留框数: " << fullResult.size() << " -> " << preResult.size()
+        << " | 与完整结果前缀一致: " << (sameBoxes(prefix, preResult) ? "是" : "否") << endl;
+}
+
+// 检查分类别批量NMS与逐类别分别做网格NMS的保留结果一致（耗时由基准测试框架统计）
+void testBatchedNMS(vector<BoundingBox> boxes, const string& distType, int numClasses = 4) {
+    assignRandomClasses(boxes, numClasses);
+    sort(boxes.begin(), boxes.end(), confidenceGreater);
+
+    GridNMS gridNMS;
+    vector<BoundingBox> perClass, perClassResult;
+    for (int c = 0; c < numClasses; ++c) {
+        perClass.clear();
+        for (const auto& b : boxes) {
+            if (b.classId == c) perClass.push_back(b);
+        }
+        vector<BoundingBox> kept = gridNMS.run(perClass);
+        perClassResult.insert(perClassResult.end(), kept.begin(), kept.end());
+    }
+
+    BatchedNMS batchedNMS;
+    vector<BoundingBox> batchedResult = batchedNMS.run(boxes);
+    // 两者只是框的先后顺序不同
+    sort(perClassResult.begin(), perClassResult.end(), confidenceGreater);
+    cout << "数据分布: " << distType
+        << " | 数据规模: " << boxes.size()
+        << " | 保留框数: " << batchedResult.size()
+        << " | 批量NMS与逐类别NMS结果一致: " << (sameBoxes(perClassResult, batchedResult) ? "是" : "否") << endl;
+}
+
+// 对比归并排序、std::sort与单/多线程基数排序在大规模数据上的排序耗时，
+// 基数排序与归并排序都是稳定的，结果应逐个相同
+void testRadixSortPerformance(const vector<BoundingBox>& boxes, const string& distType) {
+    vector<BoundingBox> mergeSorted = boxes;
+    auto start = high_resolution_clock::now();
+    mergeSort(mergeSorted, 0, mergeSorted.size() - 1);
+    auto end = high_resolution_clock::now();
+    double mergeTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    vector<BoundingBox> stdSorted = boxes;
+    start = high_resolution_clock::now();
+    sort(stdSorted.begin(), stdSorted.end(), confidenceGreater);
+    end = high_resolution_clock::now();
+    double stdTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    vector<int> order;
+    start = high_resolution_clock::now();
+    radixSortIndices(boxes, order);
+    end = high_resolution_clock::now();
+    double indexTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    vector<BoundingBox> radixSorted = boxes;
+    start = high_resolution_clock::now();
+    radixSort(radixSorted);
+    end = high_resolution_clock::now();
+    double radixTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    vector<BoundingBox> parallelSorted = boxes;
+    start = high_resolution_clock::now();
+    parallelRadixSort(parallelSorted);
+    end = high_resolution_clock::now();
+    double parallelTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    cout << "数据分布: " << distType
+        << " | 数据规模: " << boxes.size()
+        << " | 归并排序: " << mergeTime << "ms"
+        << " | std::sort: " << stdTime << "ms"
+        << " | 基数排序(下标): " << indexTime << "ms"
+        << " | 基数排序(框): " << radixTime << "ms"
+        << " | 多线程基数排序: " << parallelTime << "ms"
+        << " | 结果一致: " << (sameBoxes(mergeSorted, radixSorted) && sameBoxes(mergeSorted, parallelSorted) ? "是" : "否")
+        << endl;
+}
+
+// 对比stable_sort与并行归并排序、样本排序的耗时，三者都稳定，结果应逐个相同
+void testParallelSortPerformance(const vector<BoundingBox>& boxes, const string& distType) {
+    auto confGreater = [](const BoundingBox& a, const BoundingBox& b) { return a.confidence > b.confidence; };
+
+    vector<BoundingBox> stableSorted = boxes;
+    auto start = high_resolution_clock::now();
+    stable_sort(stableSorted.begin(), stableSorted.end(), confGreater);
+    auto end = high_resolution_clock::now();
+    double stableTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    vector<BoundingBox> mergeSorted = boxes;
+    start = high_resolution_clock::now();
+    sortlib::parallelMergeSort(mergeSorted.begin(), mergeSorted.end(), confGreater);
+    end = high_resolution_clock::now();
+    double mergeTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    // 按投影出的关键字排序：置信度取负后升序即为降序
+    vector<BoundingBox> sampleSorted = boxes;
+    start = high_resolution_clock::now();
+    sortlib::sampleSort(sampleSorted.begin(), sampleSorted.end(), less<>(), [](const BoundingBox& b) { return -b.confidence; });
+    end = high_resolution_clock::now();
+    double sampleTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    cout << "数据分布: " << distType
+        << " | 数据规模: " << boxes.size()
+        << " | 线程数: " << max(1u, thread::hardware_concurrency())
+        << " | stable_sort: " << stableTime << "ms"
+        << " | 并行归并排序: " << mergeTime << "ms"
+        << " | 样本排序: " << sampleTime << "ms"
+        << " | 结果一致: " << (sameBoxes(stableSorted, mergeSorted) && sameBoxes(stableSorted, sampleSorted) ? "是" : "否")
+        << endl;
+}
+
+// 在随机、已降序、近乎有序（1%的位置被随机交换）三种输入上对比递归归并排序与两种缓冲区复用的归并排序
+void testMergeSortPerformance(int size) {
+    vector<pair<string, vector<BoundingBox>>> inputs;
+    vector<BoundingBox> boxes = generateRandomBoxes(size);
+    inputs.push_back({ "随机置信度", boxes });
+    sort(boxes.begin(), boxes.end(), confidenceGreater);
+    inputs.push_back({ "已降序", boxes });
+    uniform_int_distribution<int> posDist(0, size - 1);
+    for (int k = 0; k < size / 100; ++k) swap(boxes[posDist(gen)], boxes[posDist(gen)]);
+    inputs.push_back({ "近乎有序", boxes });
+
+    for (auto& input : inputs) {
+        vector<BoundingBox> recursive = input.second;
+        auto start = high_resolution_clock::now();
+        mergeSort(recursive, 0, recursive.size() - 1);
+        auto end = high_resolution_clock::now();
+        double recursiveTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+        vector<BoundingBox> bottomUp = input.second;
+        start = high_resolution_clock::now();
+        bottomUpMergeSort(bottomUp);
+        end = high_resolution_clock::now();
+        double bottomUpTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+        vector<BoundingBox> natural = input.second;
+        start = high_resolution_clock::now();
+        naturalMergeSort(natural);
+        end = high_resolution_clock::now();
+        double naturalTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+        cout << "输入: " << input.first
+            << " | 数据规模: " << size
+            << " | 递归归并排序: " << recursiveTime << "ms"
+            << " | 自底向上归并排序: " << bottomUpTime << "ms"
+            << " | 自然归并排序: " << naturalTime << "ms"
+            << " | 结果一致: " << (sameBoxes(recursive, bottomUp) && sameBoxes(recursive, natural) ? "是" : "否") << endl;
+    }
+}
+
+// 是否已按置信度降序排好
+bool isSortedByConfidence(const vector<BoundingBox>& boxes) {
+    for (size_t i = 1; i < boxes.size(); ++i) {
+        if (boxes[i - 1].confidence < boxes[i].confidence) return false;
+    }
+    return true;
+}
+
+// 在随机、已降序、已升序、量化置信度、全部相同五种输入上对比朴素快速排序、新快速排序与std::sort
+// （朴素快速排序在后四种输入上是O(n^2)且递归深度为n，withNaive为false时跳过）
+void testQuickSortPerformance(int size, bool withNaive) {
+    vector<pair<string, vector<BoundingBox>>> inputs;
+    vector<BoundingBox> boxes = generateRandomBoxes(size);
+    inputs.push_back({ "随机置信度", boxes });
+    sort(boxes.begin(), boxes.end(), confidenceGreater);
+    inputs.push_back({ "已降序", boxes });
+    reverse(boxes.begin(), boxes.end());
+    inputs.push_back({ "已升序", boxes });
+    for (auto& b : boxes) b.confidence = floor(b.confidence * 100) / 100;
+    shuffle(boxes.begin(), boxes.end(), gen);
+    inputs.push_back({ "量化置信度(0.01)", boxes });
+    for (auto& b : boxes) b.confidence = 0.5f;
+    inputs.push_back({ "全部相同", boxes });
+
+    for (auto& input : inputs) {
+        double naiveTime = 0;
+        if (withNaive) {
+            vector<BoundingBox> arr = input.second;
+            auto start = high_resolution_clock::now();
+            lomutoQuickSort(arr, 0, arr.size() - 1);
+            auto end = high_resolution_clock::now();
+            naiveTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+        }
+
+        vector<BoundingBox> arr = input.second;
+        auto start = high_resolution_clock::now();
+        quickSort(arr, 0, arr.size() - 1);
+        auto end = high_resolution_clock::now();
+        double quickTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+        bool sorted = isSortedByConfidence(arr);
+
+        arr = input.second;
+        start = high_resolution_clock::now();
+        sort(arr.begin(), arr.end(), [](const BoundingBox& a, const BoundingBox& b) { return a.confidence > b.confidence; });
+        end = high_resolution_clock::now();
+        double stdTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+        cout << "输入: " << input.first
+            << " | 数据规模: " << size;
+        if (withNaive) cout << " | 朴素快速排序: " << naiveTime << "ms";
+        cout << " | 快速排序: " << quickTime << "ms"
+            << " | std::sort: " << stdTime << "ms"
+            << " | 结果有序: " << (sorted ? "是" : "否") << endl;
+    }
+}
+
+// ====================== 基准测试框架 ======================
+// 计数用的置信度：每次比较都累加比较次数，可隐式转换为float供基数排序取键
+struct CountedConfidence {
+    float value;
+    operator float() const { return value; }
+};
+
+inline bool operator<(const CountedConfidence& a, const CountedConfidence& b) {
+    benchCounters.comparisons++;
+    return a.value < b.value;
+}
+inline bool operator>(const CountedConfidence& a, const CountedConfidence& b) { return b < a; }
+inline bool operator<=(const CountedConfidence& a, const CountedConfidence& b) { return !(b < a); }
+inline bool operator>=(const CountedConfidence& a, const CountedConfidence& b) { return !(a < b); }
+
+// 计数用的框：只带排序用到的置信度和原下标，拷贝构造/赋值累加搬运次数，swap累加交换次数
+struct CountedBox {
+    CountedConfidence confidence;
+    int id;
+
+    CountedBox() : confidence{ 0.0f }, id(0) {}
+    CountedBox(float c, int i) : confidence{ c }, id(i) {}
+    CountedBox(const CountedBox& o) : confidence(o.confidence), id(o.id) { benchCounters.moves++; }
+    CountedBox& operator=(const CountedBox& o) {
+        confidence = o.confidence;
+        id = o.id;
+        benchCounters.moves++;
+        return *this;
+    }
+};
+
+inline void swap(CountedBox& a, CountedBox& b) {
+    std::swap(a.confidence, b.confidence);
+    std::swap(a.id, b.id);
+    benchCounters.swaps++;
+}
+
+// 基准测试配置
+struct BenchConfig {
+    int warmupRuns = 1;               // 预热次数，不计入统计
+    int repetitions = 11;             // 计时次数上限
+    int minRepetitions = 3;           // 单项累计耗时超过maxMsPerCase后停止，但至少计时这么多次
+    double maxMsPerCase = 1000.0;
+    bool flushCache = true;           // 每次计时前写一遍64MB缓冲区，把上一次运行留在缓存中的数据挤出去
+    unsigned seed = DEFAULT_SEED;     // 每组数据用 seed+规模 重新播种，结果可复现
+    string csvPath = "bench_results/exp4_bench.csv";    // 所在目录不存在时自动创建
+    string jsonPath = "bench_results/exp4_bench.json";
+};
+
+// 一项测试的统计结果，计数为-1表示该项不适用
+struct BenchResult {
+    string distribution, method;
+    int size = 0, runs = 0;
+    double medianMs = 0, p99Ms = 0, meanMs = 0, stddevMs = 0, minMs = 0;
+    long long comparisons = -1, swaps = -1, moves = -1, iouEvaluations = -1, kept = -1;
+    bool valid = true;                // 排序结果是否有序
+};
+
+// 基准测试框架：预热后多次计时，统计中位数、p99、均值、标准差和最小值；
+// 计数取自一次不计时的运行，所有结果可导出为CSV和JSON以便跟踪性能回退
+class BenchHarness {
+public:
+    explicit BenchHarness(const BenchConfig& cfg = BenchConfig()) : config(cfg) {
+        config.repetitions = max(1, config.repetitions);  // 至少计时一次，统计才有样本
+        if (config.flushCache) flushBuffer.assign(64 << 20, 0);
+    }
+
+    const BenchConfig& getConfig() const { return config; }
+    const vector<BenchResult>& results() const { return allResults; }
+
+    // 排序测试：sortFunc须能同时接受vector<BoundingBox>&（计时）和vector<CountedBox>&（计数），
+    // 一般写成泛型lambda
+    template <typename SortFunc>
+    void benchSort(const string& distribution, const string& method,
+        const vector<BoundingBox>& input, SortFunc sortFunc) {
+        vector<BoundingBox> work;
+        BenchResult r = measure([&]() { work = input; }, [&]() { sortFunc(work); });
+        r.valid = isSortedByConfidence(work);
+
+        vector<CountedBox> counted;
+        counted.reserve(input.size());
+        for (int i = 0; i < (int)input.size(); ++i) counted.emplace_back(input[i].confidence, i);
+        benchCounters.reset();
+        sortFunc(counted);
+        r.comparisons = benchCounters.comparisons;
+        r.swaps = benchCounters.swaps;
+        r.moves = benchCounters.moves;
+        record(r, distribution, method, input.size());
+    }
+
+    // NMS测试：输入须已按置信度降序排好，nmsFunc返回保留的框；
+    // 先不计时地运行一次统计保留框数，定义COUNT_IOU编译时同时统计IoU计算次数
+    template <typename NMSFunc>
+    void benchNMS(const string& distribution, const string& method,
+        const vector<BoundingBox>& sortedInput, NMSFunc nmsFunc) {
+        benchCounters.reset();
+        long long kept = nmsFunc(sortedInput).size();
+        long long evaluated = benchCounters.iouEvaluations;
+
+        BenchResult r = measure([]() {}, [&]() { nmsFunc(sortedInput); });
+#ifdef COUNT_IOU
+        r.iouEvaluations = evaluated;
+#else
+        (void)evaluated;
+#endif
+        r.kept = kept;
+        record(r, distribution, method, sortedInput.size());
+    }
+
+    // 导出全部结果，成功返回true
+    bool writeCSV() const {
+        makeParentDirs(config.csvPath);
+        ofstream out(config.csvPath);
+        if (!out) return false;
+        out << "distribution,size,method,runs,median_ms,p99_ms,mean_ms,stddev_ms,min_ms,"
+            "comparisons,swaps,moves,iou_evaluations,kept,valid\n";
+        for (const auto& r : allResults) {
+            out << r.distribution << "," << r.size << "," << r.method << "," << r.runs << ","
+                << r.medianMs << "," << r.p99Ms << "," << r.meanMs << "," << r.stddevMs << "," << r.minMs << ","
+                << r.comparisons << "," << r.swaps << "," << r.moves << "," << r.iouEvaluations << ","
+                << r.kept << "," << (r.valid ? 1 : 0) << "\n";
+        }
+        return true;
+    }
+
+    bool writeJSON() const {
+        makeParentDirs(config.jsonPath);
+        ofstream out(config.jsonPath);
+        if (!out) return false;
+        out << "{\n  \"seed\": " << config.seed
+            << ",\n  \"warmupRuns\": " << config.warmupRuns
+            << ",\n  \"repetitions\": " << config.repetitions
+            << ",\n  \"flushCache\": " << (config.flushCache ? "true" : "false")
+            << ",\n  \"results\": [";
+        for (size_t k = 0; k < allResults.size(); ++k) {
+            const BenchResult& r = allResults[k];
+            out << (k ? ",\n" : "\n") << "    {\"distribution\": \"" << r.distribution
+                << "\", \"size\": " << r.size << ", \"method\": \"" << r.method
+                << "\", \"runs\": " << r.runs << ", \"median_ms\": " << r.medianMs
+                << ", \"p99_ms\": " << r.p99Ms << ", \"mean_ms\": " << r.meanMs
+                << ", \"stddev_ms\": " << r.stddevMs << ", \"min_ms\": " << r.minMs
+                << ", \"comparisons\": " << r.comparisons << ", \"swaps\": " << r.swaps
+                << ", \"moves\": " << r.moves << ", \"iou_evaluations\": " << r.iouEvaluations
+                << ", \"kept\": " << r.kept << ", \"valid\": " << (r.valid ? "true" : "false") << "}";
+        }
+        out << "\n  ]\n}\n";
+        return true;
+    }
+
+private:
+    BenchConfig config;
+    vector<BenchResult> allResults;
+    vector<char> flushBuffer;
+    volatile char flushSink = 0;
+
+    // 逐级创建path所在的目录，已存在的目录跳过
+    static void makeParentDirs(const string& path) {
+        for (size_t i = path.find_first_of("/\\", 1); i != string::npos; i = path.find_first_of("/\\", i + 1)) {
+            string dir = path.substr(0, i);
+#ifdef _WIN32
+            _mkdir(dir.c_str());
+#else
+            mkdir(dir.c_str(), 0755);
+#endif
+        }
+    }
+
+    // 每隔64字节写一次，使整个缓冲区的缓存行都被载入并弄脏
+    void flushCaches() {
+        for (size_t i = 0; i < flushBuffer.size(); i += 64) flushBuffer[i]++;
+        flushSink = flushBuffer[flushBuffer.size() / 2];
+    }
+
+    // setup在每次运行前执行（不计时），body为被测代码
+    template <typename Setup, typename Body>
+    BenchResult measure(Setup setup, Body body) {
+        for (int w = 0; w < config.warmupRuns; ++w) {
+            setup();
+            body();
+        }
+        vector<double> samples;
+        double total = 0;
+        for (int rep = 0; rep < config.repetitions; ++rep) {
+            if (rep >= config.minRepetitions && total > config.maxMsPerCase) break;
+            setup();
+            if (config.flushCache) flushCaches();
+            auto start = steady_clock::now();
+            body();
+            auto end = steady_clock::now();
+            double ms = duration_cast<nanoseconds>(end - start).count() / 1e6;
+            samples.push_back(ms);
+            total += ms;
+        }
+
+        BenchResult r;
+        sort(samples.begin(), samples.end());
+        int n = samples.size();
+        r.runs = n;
+        r.minMs = samples[0];
+        r.medianMs = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+        r.p99Ms = samples[(int)ceil(0.99 * n) - 1];  // 最近秩法
+        r.meanMs = total / n;
+        double var = 0;
+        for (double x : samples) var += (x - r.meanMs) * (x - r.meanMs);
+        r.stddevMs = n > 1 ? sqrt(var / (n - 1)) : 0;
+        return r;
+    }
+
+    void record(BenchResult& r, const string& distribution, const string& method, int size) {
+        r.distribution = distribution;
+        r.method = method;
+        r.size = size;
+        allResults.push_back(r);
+        cout << "数据分布: " << distribution
+            << " | 数据规模: " << size
+            << " | 方法: " << method
+            << " | 中位数: " << r.medianMs << "ms"
+            << " | p99: " << r.p99Ms << "ms"
+            << " | 标准差: " << r.stddevMs << "ms"
+            << " | 次数: " << r.runs;
+        if (r.comparisons >= 0) {
+            cout << " | 比较: " << r.comparisons << " | 交换: " << r.swaps << " | 搬运: " << r.moves;
+        }
+        if (r.iouEvaluations >= 0) cout << " | IoU计算: " << r.iouEvaluations;
+        if (r.kept >= 0) cout << " | 保留框数: " << r.kept;
+        if (!r.valid) cout << " | 结果无序!";
+        cout << endl;
+    }
+};
+
+// 在一组数据上跑全部排序与NMS基准测试（每组数据用固定种子生成）
+void runBenchSuite(BenchHarness& harness, const string& distribution,
+    vector<BoundingBox>(*generate)(int), int size) {
+    gen.seed(harness.getConfig().seed + size);
+    vector<BoundingBox> boxes = generate(size);
+
+    harness.benchSort(distribution, "冒泡排序", boxes, [](auto& v) { bubbleSort(v); });
+    harness.benchSort(distribution, "插入排序", boxes, [](auto& v) { insertionSort(v); });
+    harness.benchSort(distribution, "归并排序", boxes, [](auto& v) { mergeSort(v, 0, v.size() - 1); });
+    harness.benchSort(distribution, "自底向上归并排序", boxes, [](auto& v) { bottomUpMergeSort(v); });
+    harness.benchSort(distribution, "自然归并排序", boxes, [](auto& v) { naturalMergeSort(v); });
+    harness.benchSort(distribution, "快速排序", boxes, [](auto& v) { quickSort(v, 0, v.size() - 1); });
+    harness.benchSort(distribution, "基数排序", boxes, [](auto& v) { radixSort(v); });
+    harness.benchSort(distribution, "并行归并排序", boxes,
+        [](auto& v) { sortlib::parallelMergeSort(v.begin(), v.end(), greater<>(), ConfidenceOf()); });
+    harness.benchSort(distribution, "样本排序", boxes,
+        [](auto& v) { sortlib::sampleSort(v.begin(), v.end(), greater<>(), ConfidenceOf()); });
+    harness.benchSort(distribution, "sortlib::sort", boxes,
+        [](auto& v) { sortlib::sort(v.begin(), v.end(), greater<>(), ConfidenceValue()); });
+    harness.benchSort(distribution, "std::sort", boxes,
+        [](auto& v) { sort(v.begin(), v.end(), [](const auto& a, const auto& b) { return a.confidence > b.confidence; }); });
+
+    sort(boxes.begin(), boxes.end(), confidenceGreater);
+    VectorizedNMS vecNMS;
+    BitmaskNMS maskNMS;
+    GridNMS gridNMS;
+    harness.benchNMS(distribution, "基础NMS", boxes, [](const vector<BoundingBox>& b) { return basicNMS(b); });
+    harness.benchNMS(distribution, "向量化NMS", boxes, [&](const vector<BoundingBox>& b) { return vecNMS.run(b); });
+    harness.benchNMS(distribution, "位掩码NMS", boxes, [&](const vector<BoundingBox>& b) { return maskNMS.run(b); });
+    harness.benchNMS(distribution, "网格NMS", boxes, [&](const vector<BoundingBox>& b) { return gridNMS.run(b); });
+
+    // 分类别的方法在同一组框上随机指定4个类别后测试
+    vector<BoundingBox> classed = boxes;
+    assignRandomClasses(classed, 4);
+    BatchedNMS batchedNMS;
+    SoftNMS linearNMS(SoftNMS::LINEAR), gaussianNMS(SoftNMS::GAUSSIAN);
+    WeightedBoxFusion wbf;
+    harness.benchNMS(distribution, "分类别批量NMS", classed, [&](const vector<BoundingBox>& b) { return batchedNMS.run(b); });
+    harness.benchNMS(distribution, "Soft-NMS(线性)", classed, [&](const vector<BoundingBox>& b) { return linearNMS.run(b); });
+    harness.benchNMS(distribution, "Soft-NMS(高斯)", classed, [&](const vector<BoundingBox>& b) { return gaussianNMS.run(b); });
+    harness.benchNMS(distribution, "加权框融合", classed, [&](const vector<BoundingBox>& b) { return wbf.run(b); });
+}
+
+// 模拟视频流：每帧有moveRate比例的目标按各自的速度移动（再加±1像素的噪声），changeRate比例的目标换成新目标，
+// 其余目标原地不动；所有框的置信度每帧都有小幅波动，保留顺序会随之变化。
+// 对比逐帧独立的网格NMS与视频流NMS的单帧耗时（中位数、p99），并逐帧检查两者保留结果相同
+void testStreamingNMS(int boxesPerFrame, int frames, float moveRate = 0.1f, float changeRate = 0.02f) {
+    gen.seed(DEFAULT_SEED + boxesPerFrame);
+    uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    uniform_real_distribution<float> speed(-0.3f, 0.3f);
+    uniform_real_distribution<float> confJitter(-0.02f, 0.02f);
+    uniform_real_distribution<float> unit(0.0f, 1.0f);
+    vector<BoundingBox> objects = generateRandomBoxes(boxesPerFrame), detections(boxesPerFrame);
+    vector<float> vx(boxesPerFrame), vy(boxesPerFrame);
+    for (int i = 0; i < boxesPerFrame; ++i) {
+        vx[i] = speed(gen);
+        vy[i] = speed(gen);
+    }
+
+    GridNMS gridNMS;
+    StreamingNMS streamNMS(boxesPerFrame);
+    vector<double> gridTimes, streamTimes;
+    double kept = 0, statics = 0;
+    bool same = true;
+    vector<BoundingBox> sortedFrame, gridResult;
+    for (int f = 0; f < frames; ++f) {
+        for (int i = 0; i < boxesPerFrame; ++i) {
+            BoundingBox& o = objects[i];
+            float u = unit(gen);
+            if (f > 0 && u < changeRate) {
+                o = generateRandomBoxes(1)[0];
+            }
+            else if (f > 0 && u < changeRate + moveRate) {
+                float dx = vx[i] + noise(gen), dy = vy[i] + noise(gen);
+                o.x1 += dx; o.x2 += dx;
+                o.y1 += dy; o.y2 += dy;
+            }
+            detections[i] = o;
+            detections[i].confidence = min(1.0f, max(0.0f, o.confidence + confJitter(gen)));
+        }
+        sortedFrame = detections;
+        sort(sortedFrame.begin(), sortedFrame.end(), confidenceGreater);
+
+        auto start = high_resolution_clock::now();
+        gridResult = gridNMS.run(sortedFrame);
+        auto mid = high_resolution_clock::now();
+        const vector<BoundingBox>& streamResult = streamNMS.processFrame(sortedFrame);
+        auto end = high_resolution_clock::now();
+        kept += gridResult.size();
+        statics += streamNMS.lastStaticCount();
+        if (!sameBoxes(gridResult, streamResult)) same = false;
+        gridTimes.push_back(duration_cast<nanoseconds>(mid - start).count() / 1e6);
+        streamTimes.push_back(duration_cast<nanoseconds>(end - mid).count() / 1e6);
+    }
+
+    // 首帧没有可沿用的结论，不计入稳态统计
+    auto percentile = [](vector<double> t, double q) {
+        t.erase(t.begin());
+        sort(t.begin(), t.end());
+        return t[(size_t)ceil(q * t.size()) - 1];
+    };
+    cout << "每帧框数: " << boxesPerFrame
+        << " | 帧数: " << frames
+        << " | 网格NMS单帧: 中位数 " << percentile(gridTimes, 0.5) << "ms, p99 " << percentile(gridTimes, 0.99) << "ms"
+        << " | 视频流NMS单帧: 中位数 " << percentile(streamTimes, 0.5) << "ms, p99 " << percentile(streamTimes, 0.99) << "ms"
+        << " | 平均保留框数: " << kept / frames
+        << " | 平均未移动框数: " << statics / frames
+        << " | 结果与逐帧NMS一致: " << (same ? "是" : "否") << endl;
 }
 
 int main() {
     // 测试的数据集规模列表
     vector<int> testSizes = { 100, 1000, 5000, 10000 };
-    // 排序算法列表（函数指针+名称）
-    vector<pair<void (*)(vector<BoundingBox>&), string>> sortAlgos = {
-        {bubbleSort<BoundingBox>, "冒泡排序"},
-        {insertionSort<BoundingBox>, "插入排序"},
-        {[](vector<BoundingBox>& arr) { mergeSort(arr, 0, arr.size() - 1); }, "归并排序"},
-        {[](vector<BoundingBox>& arr) { quickSort(arr, 0, arr.size() - 1); }, "快速排序"}
-    };
 
+    BenchHarness harness;
     cout << "========== 随机分布数据集测试 ==========" << endl;
     for (int size : testSizes) {
-        vector<BoundingBox> boxes = generateRandomBoxes(size);
-        for (auto& algo : sortAlgos) {
-            testSortPerformance(algo.second, algo.first, boxes, "随机分布");
-        }
+        runBenchSuite(harness, "随机分布", generateRandomBoxes, size);
         cout << "----------------------------------------" << endl;
     }
 
     cout << "\n========== 聚集分布数据集测试 ==========" << endl;
     for (int size : testSizes) {
-        vector<BoundingBox> boxes = generateClusteredBoxes(size);
-        for (auto& algo : sortAlgos) {
-            testSortPerformance(algo.second, algo.first, boxes, "聚集分布");
-        }
+        runBenchSuite(harness, "聚集分布", generateClusteredBoxes, size);
         cout << "----------------------------------------" << endl;
     }
+    if (harness.writeCSV() && harness.writeJSON()) {
+        cout << "测试结果已写入 " << harness.getConfig().csvPath << " 和 " << harness.getConfig().jsonPath << endl;
+    }
+
+    cout << "\n========== 归并排序缓冲区复用测试 ==========" << endl;
+    testMergeSortPerformance(1000000);
+
+    cout << "\n========== 并行排序测试 ==========" << endl;
+    testParallelSortPerformance(generateRandomBoxes(10000000), "随机分布");
+
+    cout << "\n========== 快速排序退化输入测试 ==========" << endl;
+    testQuickSortPerformance(10000, true);
+    testQuickSortPerformance(1000000, false);
+
+    cout << "\n========== 基数排序测试 ==========" << endl;
+    for (int size : { 100000, 1000000 }) {
+        testRadixSortPerformance(generateRandomBoxes(size), "随机分布");
+        testRadixSortPerformance(generateClusteredBoxes(size), "聚集分布");
+    }
+
+    cout << "\n========== 加速NMS对比测试 ==========" << endl;
+    for (int size : { 10000, 20000, 50000, 100000 }) {
+        testNMSPerformance(generateRandomBoxes(size), "随机分布", size <= 20000);
+        testNMSPerformance(generateClusteredBoxes(size), "聚集分布", size <= 20000);
+    }
+
+    cout << "\n========== NMS前置筛选测试（阈值0.5, Top1000, 最多300个）==========" << endl;
+    for (int size : { 10000, 100000 }) {
+        testPreNMSPerformance(generateRandomBoxes(size), "随机分布");
+        testPreNMSPerformance(generateClusteredBoxes(size), "聚集分布");
+    }
+
+    cout << "\n========== 分类别批量NMS结果检查（4个类别）==========" << endl;
+    for (int size : { 10000, 20000 }) {
+        testBatchedNMS(generateRandomBoxes(size), "随机分布");
+        testBatchedNMS(generateClusteredBoxes(size), "聚集分布");
+    }
+
+    cout << "\n========== 视频流逐帧NMS测试（每帧10%的目标移动，2%换成新目标）==========" << endl;
+    testStreamingNMS(2000, 200);
+    testStreamingNMS(20000, 50);
 
     return 0;
 }
\ No newline at end of file